@@ -6,41 +6,24 @@
  *
  * Reference(s): cplusplus.com
  *
- * Description:  Actor object (main node in ActorGraph). Holds the name
- *               of actor, distance from a specified origin acter to this,
+ * Description:  Actor object (main node in ActorGraph). Holds the id of
+ *               the actor, which is also the id of its name in the graph's
+ *               NameIndex, distance from a specified origin acter to this,
  *               a pointer the adjacent actor in a shortest path from origin,
- *               and the movie connecting them. Contains a collection of movies
- *               this actor starred in.
+ *               and the movie connecting them. The movies this actor starred
+ *               in are kept by the ActorGraph, indexed by the actor's id.
  */
 
 #include "Actor.hpp"
 #include "Movie.hpp"
 
-/** create new actor with actor name, name */
-Actor::Actor(string& name)
+/** create new actor at index id of the graph, named by name id in its NameIndex */
+Actor::Actor(int id)
 {
-    this->name = name;
+    this->id = id;
     wasProcessed = false;
     dist = -1;
     prev = nullptr;
     edge = nullptr;
     numBelow = 0;
 }
-
-/** Update actor's movie collection if they starred in a new movie.
-*   Else, updateActor will do nothing
-**/
-void Actor::updateCollection(Movie* movie)
-{
-    // key for a movie is movie year appended to movie name
-    string key = movie->getMovieName() + to_string(movie->getMovieYear());
-
-    // find the movie, if it exists
-    auto movieItr = movies.find(key);
-
-    // reject duplicate movie (already in their collection)
-    if(movieItr != movies.end()) return;
-
-    // If here, actor starred in a new movie. Update their collection.
-    movies.insert(movieVal(key, movie));
-}
\ No newline at end of file
@@ -6,11 +6,12 @@
  *
  * Reference(s): cplusplus.com
  *
- * Description:  Actor object (main node in ActorGraph). Holds the name
- *               of actor, distance from a specified origin actor to this,
+ * Description:  Actor object (main node in ActorGraph). Holds the id of
+ *               the actor, which is also the id of its name in the graph's
+ *               NameIndex, distance from a specified origin actor to this,
  *               a pointer the adjacent actor in a shortest path from origin,
- *               and the movie connecting them. Contains a collection of movies
- *               this actor starred in.
+ *               and the movie connecting them. The movies this actor starred
+ *               in are kept by the ActorGraph, indexed by the actor's id.
  */
 
 #ifndef PA4_ACTOR_HPP
@@ -24,13 +25,12 @@ using namespace std;
 
 class Movie;
 
-typedef unordered_map<string, Movie*> Collection;
 typedef pair<string, Movie*> movieVal; // key-value pair of movie
 
 class Actor {
 private:
     int dist;
-    string name; // actor name
+    int id;      // index of this actor in the ActorGraph and of its name in the NameIndex
     Actor* prev;
     Movie* edge;
 
@@ -38,13 +38,9 @@ public:
 
     int numBelow; // number of nodes below this node
     bool wasProcessed;
-    Collection movies; // movies this actor starred in
 
     /** constructor */
-    Actor(string& name);
-
-    /** Connect actor to the movie */
-    void updateCollection(Movie* movie);
+    Actor(int id);
 
     /** set dist from specified origin actor to this actor */
     void setDist(int dist) {this->dist = dist;}
@@ -61,11 +57,14 @@ public:
     /** get the incoming actor to this actor for shortest path traversal */
     Actor* getPrev() {return prev;}
 
-    /** get name of this acter */
-    string getName() {return name;}
+    /** get index of this actor in the ActorGraph */
+    int getId() {return id;}
 
     /** get movie name connecting incoming actor for shortest path travers */
     Movie* getEdge() {return edge;}
+
+    /** bytes used by this actor; its name is held by the NameIndex */
+    size_t memoryBytes() const {return sizeof(Actor);}
 };
 
 
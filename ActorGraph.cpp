@@ -13,175 +13,488 @@
  * Arguments: input file, u/w, pairs, output
  */
  
+#include <algorithm>
+#include <atomic>
+#include <climits>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "ActorGraph.hpp"
+#include "CastReader.hpp"
 #include "Movie.hpp"
+#include "WorkerPool.hpp"
 
 using namespace std;
 
+/** copy text into a key of Map, so its text is charged like the rest of Map */
+template <class Map>
+static typename Map::key_type keyOf(const string& text)
+{
+    return typename Map::key_type(text.data(), text.size());
+}
+
 /**
  * Constructor of the Actor graph
  */ 
 ActorGraph::ActorGraph()
 {
-    pq = priority_queue<Actor*, vector<Actor*>, ActCompare>();
-    processed = unordered_map<string, Actor*>();
-    ordEdges = priority_queue<Movie*, vector<Movie*>, MovCompare>();
+    pq = actor_pq();
+    processed = hash_table();
+    ordEdges = movie_pq();
     numActors = 0;
+    baseMovies = 0;
+    windowStart = windowEnd = 0;
+    addedStart = addedEnd = 0;
+    weighted = false;
+    maxHops = maxStrength = -1;
+    kernel = nullptr;
+    kernelWeights = CUSTOM_WEIGHT;
+    kernelFrontier = GENERIC_SEARCH;
+    bucketSpan = 1;
+    minWindowYear = INT_MIN;
+    maxWindowYear = INT_MAX;
+    hasMST = false;
+    mstWeight = 0;
+    numWorkers = 1;
+    workerTimeout = 0;
+    numPaths = 1;
+    unitPaths = true;
 }
 
 /** Destroy the graph */
 ActorGraph::~ActorGraph() {
     // delete all actor nodes
-    for(actorVal actor : actors)
-        delete actor.second;
+    for(Actor* actor : actorById)
+        delete actor;
 
     // delete all movies
-    for(movieVal movie : movieArchive)
-        delete movie.second;
+    for(Movie* movie : movieById)
+        delete movie;
 }
 
 /** Load the graph from a tab-delimited file of actor->movie relationships.
  *
- * in_filename - input filename
+ * in_filename - input filename, plain or gzip compressed
  * use_weighted_edges - if true, compute edge weights as 1 + (2019 - movie_year)
  *                      otherwise all edge weights will be 1
  *
+ * The file goes through a pipeline of stages on their own threads:
+ * block reader -> tokenizer -> interner (this thread) -> incidence builder,
+ * joined by bounded queues, so the load takes as long as the slowest stage.
+ *
+ * Loading another file adds its actors and movies to the graph. If the MST
+ * was already built, the new movies update it in place.
+ *
  * return true if file was loaded successfully, false otherwise
  */
 bool ActorGraph::loadFromFile(char* in_filename, bool useWeight, bool isTrav)
 {
+    const int QUEUE_SIZE = 8; // blocks or batches in flight between stages
+    CastReader reader(in_filename);
+    SpscQueue<CastBlock*> blocks(QUEUE_SIZE);
+    SpscQueue<RecordBatch*> records(QUEUE_SIZE);
+    SpscQueue<incidence_vector*> incidences(QUEUE_SIZE);
+
+    weighted = useWeight;
+
+    // nodes past these counts are new, and dropped again if the load fails
+    int oldActors = actorById.size();
+    int oldMovies = movieById.size();
+
+    // movies that exist now are only noted once if this load adds to them
+    loadedMovies.clear();
+    movieLoaded.assign(movieById.size(), 0);
+
+    // start every stage but the interner, which needs no extra thread
+    thread readStage([&]() { reader.readBlocks(blocks); });
+    thread tokenStage([&]() { reader.tokenize(blocks, records); });
+    thread buildStage([&]() { appendIncidences(incidences); });
+
+    internRecords(records, incidences, useWeight);
+
+    readStage.join();
+    tokenStage.join();
+    buildStage.join();
+
+    if (reader.hasFailed()) {
+        cerr << "Failed to read " << in_filename << "!\n";
+        rollbackLoad(oldActors, oldMovies);
+        return false;
+    }
+
+    // pack actor->movie and movie->actor lists now that all lines are read
+    buildIncidence();
+    names.settle();
+
+    /** the bucket span was sized for the movies loaded before; select the
+     *  search again so it covers the new ones. Buckets cannot order
+     *  negative weights, but a heap can
+     */
+    if(kernel && !selectKernel(kernelWeights, kernelFrontier))
+    {
+        cerr << "New movies have weights the bucket search cannot order; "
+                "using heap search." << endl;
+        selectKernel(kernelWeights, HEAP_FRONTIER);
+    }
+
+    // fold the new movies into the tree rather than running Kruskal again
+    if(hasMST) updateMST();
+
+    loadedMovies.clear();
+    movieLoaded = vector<char>();
+    return true;
+}
+
+/** Undo a failed loadFromFile: delete the actors and movies it interned
+ *  past the first oldActors and oldMovies, and the incidences it read,
+ *  so the graph is left as the previous load built it
+ */
+void ActorGraph::rollbackLoad(int oldActors, int oldMovies)
+{
+    /** keep only the movies of earlier loads queued for Kruskal. Done before
+     *  any movie is deleted, since popping compares the queued movies
+     */
+    movie_pq kept;
+    for(; !ordEdges.empty(); ordEdges.pop())
+        if(ordEdges.top()->getId() < oldMovies) kept.push(ordEdges.top());
+    ordEdges = kept;
+
+    for(unsigned int i = oldMovies; i < movieById.size(); ++i)
+    {
+        Movie* movie = movieById[i];
+
+        movieArchive.erase(keyOf<movie_archive>(movie->getMovieName()
+                                                + to_string(movie->getMovieYear())));
+        delete movie;
+    }
 
-    // Initialize the file stream
-    ifstream infile(in_filename);
+    for(unsigned int i = oldActors; i < actorById.size(); ++i)
+        delete actorById[i];
 
-    bool have_header = false;
+    movieById.resize(oldMovies);
+    actorById.resize(oldActors);
+    numActors = oldActors;
+
+    names.truncate(oldActors);
+    newIncidences = incidence_vector();
+    loadedMovies.clear();
+    movieLoaded = vector<char>();
+}
+
+/** Interner stage of loadFromFile: turn each record's names into an Actor
+ *  and a Movie, creating them when first seen, and pass the <actor id,
+ *  movie id> pairs on to the incidence builder
+ */
+void ActorGraph::internRecords(SpscQueue<RecordBatch*>& records,
+                               SpscQueue<incidence_vector*>& incidences,
+                               bool useWeight)
+{
+    RecordBatch* batch;
     Actor* newActor;
     Movie* newMovie;
-    string movieKey;
-  
-    // keep reading lines until the end of file is reached
-    while (infile) {
-        string s;
-    
-        // get the next line
-        if (!getline( infile, s )) break;
-
-        if (!have_header) {
-
-            // skip the header
-            have_header = true;
-            continue;
-        }
+    movie_archive::key_type movieKey;
 
-        istringstream ss( s );
-        vector <string> record;
+    while((batch = records.pop()) != nullptr)
+    {
+        incidence_vector* pairs = new incidence_vector();
+        pairs->reserve(batch->records.size());
 
-        while (ss) {
-            string next;
-      
-            // get the next string before hitting a tab character and put it in 'next'
-            if (!getline( ss, next, '\t' )) break;
+        for(CastRecord& record : batch->records)
+        {
+            // get their movie and movie year
+            string movie_title(record.movie, record.movieLen);
+            int movie_year = record.year;
+            bool newName; // true if this actor's name was not seen before
+
+            /** one lookup in the name index finds the actor, or interns the
+            *   name with the next id if this actor has not been recorded
+            */
+            int actorId = names.intern(record.actor, record.actorLen, newName);
+
+            /** if the actor did not exist, add them to the graph under the id
+             *  of their name. Hold a pointer to the actor to work on it later
+             */
+            if(newName)
+            {
+                newActor = new Actor(actorId);
+                actorById.push_back(newActor);
+                ++numActors;
+            }
 
-            record.push_back( next );
-        }
-    
-        if (record.size() != 3) {
-            // we should have exactly 3 columns
-            continue;
-        }
+            // else, the actor existed, so just remember it
+            else
+                newActor = actorById[actorId];
+
+            /** movies are inserted in an Archive, a collection to
+            *   hold all movie connecting actors.
+            *   Check if this movie has been recorded
+            */
+            movieKey = keyOf<movie_archive>(movie_title + to_string(movie_year));
+            auto movieItr = movieArchive.find(movieKey);
+
+            /** create a new movie in the archive if it does not exist
+             *  hold pointer to the movie to work on it later.
+             *  Also, insert the new movie into a pq sorted, least to greatest,
+             *  strength.
+             */
+            if(movieItr == movieArchive.end())
+            {
+                newMovie = new Movie(movie_title, movie_year, useWeight,
+                                     movieById.size());
+                movieArchive.insert(movie_archive::value_type(movieKey, newMovie));
+                movieById.push_back(newMovie);
+                loadedMovies.push_back(newMovie);
+
+                // a built MST takes new movies through updateMST instead
+                if(!hasMST) ordEdges.push(newMovie);
+            }
 
-        // get actor name, their movie and movie year
-        string actor_name(record[0]);
-        string movie_title(record[1]);
-        int movie_year = stoi(record[2]);
+            // else, the movie existed, so just remember it
+            else
+            {
+                newMovie = movieItr->second;
 
-        /** actors are inserted in an ActorCollection, a collection to
-        *   hold all actors in the graph. Check if this actor has been recorded
-        */
-        auto actorItr = actors.find(actor_name);
+                // movie of an earlier load that this load adds cast to
+                if(newMovie->getId() < (int)movieLoaded.size()
+                   && !movieLoaded[newMovie->getId()])
+                {
+                    movieLoaded[newMovie->getId()] = 1;
+                    loadedMovies.push_back(newMovie);
+                }
+            }
 
-        /** if the actor did not exist, add them to the ActorCollection/graph
-         *  Hold a pointer to the actor to work on it later
-         */
-        if(actorItr == actors.end())
-        {
-            newActor = new Actor(actor_name);
-            actors.insert(actorVal(actor_name, newActor)); // add actor to graph
-            ++numActors;
+            /** record that actor starred in movie. Duplicates are dropped when
+             *  the incidences are compressed
+             */
+            pairs->push_back(incidence(newActor->getId(), newMovie->getId()));
         }
 
-        // else, the actor existed, so just remember it
-        else
-            newActor = actorItr->second;
-
-        /** movies are inserted in an Archive, a collection to
-        *   hold all movie connecting actors.
-        *   Check if this movie has been recorded
-        */
-        movieKey = movie_title + to_string(movie_year);
-        auto movieItr = movieArchive.find(movieKey);
-
-        /** create a new movie in the archive if it does not exist
-         *  hold pointer to the movie to work on it later.
-         *  Also, insert the new movie into a pq sorted, least to greatest,
-         *  strength.
-         */
-        if(movieItr == movieArchive.end())
-        {
-            newMovie = new Movie(movie_title, movie_year, useWeight);
-            movieArchive.insert(movieVal(movieKey, newMovie));
-            ordEdges.push(newMovie);
-        }
+        // names were copied out above; the block text can go
+        delete batch->block;
+        delete batch;
 
-        // else, the movie existed, so just remember it
-        else
-            newMovie = movieItr->second;
+        incidences.push(pairs);
+    }
 
-        /** check to see if actor needs to add a new movie to their collection
-         *  and also check to see if actor must be added to the cast of the
-         *  movie
-         */
+    incidences.push(nullptr);
+}
+
+/** Incidence builder stage of loadFromFile: collect the <actor id, movie id>
+ *  pairs until they are compressed
+ */
+void ActorGraph::appendIncidences(SpscQueue<incidence_vector*>& incidences)
+{
+    incidence_vector* pairs;
 
-        updateGraph(newActor, newMovie);
+    while((pairs = incidences.pop()) != nullptr)
+    {
+        newIncidences.insert(newIncidences.end(), pairs->begin(), pairs->end());
+        delete pairs;
     }
+}
 
-    if (!infile.eof()) {
-        cerr << "Failed to read " << in_filename << "!\n";
-        return false;
+/** check if movie m1 was released before movie m2 */
+static bool releasedBefore(Movie* m1, Movie* m2)
+{
+    return m1->getMovieYear() < m2->getMovieYear();
+}
+
+/** Compress the incidences read by loadFromFile into actorMovies and movieCast.
+ *  Movies are renumbered in order of release year first. Small loads go
+ *  to the added lists through addIncidence instead
+ */
+void ActorGraph::buildIncidence()
+{
+    incidence_vector byMovie; // same incidences keyed by movie instead
+    vector<int> newId(movieById.size()); // movie id after renumbering by year
+    int movieId;
+
+    /** rebuilding decodes and sorts every incidence, so it only pays off
+     *  once the added lists would grow past a quarter of the built ones
+     */
+    size_t built = actorMovies.size() - actorMovies.addedSize();
+    if(built && (actorMovies.addedSize() + newIncidences.size()) * 4 <= built)
+    {
+        addIncidence();
+        return;
     }
 
-    infile.close();
-    return true;
+    // incidences of earlier loads are rebuilt together with the new ones
+    for(int actorId = 0; actorId < actorMovies.numLists(); ++actorId)
+    {
+        IncidenceList::Cursor movieItr = actorMovies.list(actorId);
+
+        while(movieItr.next(movieId))
+            newIncidences.push_back(incidence(actorId, movieId));
+    }
+
+    /** order movies by year so every actor's movie list is also sorted by
+     *  year, and a year window is a single range of movie ids
+     */
+    stable_sort(movieById.begin(), movieById.end(), releasedBefore);
+
+    for(unsigned int i = 0; i < movieById.size(); ++i)
+    {
+        newId[movieById[i]->getId()] = i;
+        movieById[i]->setId(i);
+    }
+
+    byMovie.reserve(newIncidences.size());
+    for(incidence& inc : newIncidences)
+    {
+        inc.second = newId[inc.second];
+        byMovie.push_back(incidence(inc.second, inc.first));
+    }
+
+    // both directions sort independently; build them side by side
+    thread castBuild([&]() { movieCast.build(movieById.size(), byMovie); });
+    actorMovies.build(actorById.size(), newIncidences);
+    castBuild.join();
+
+    // raw incidences are no longer needed; release their memory
+    newIncidences = incidence_vector();
+    baseMovies = movieById.size();
+
+    // movie ids changed, so find the year window's range again
+    setYearWindow(minWindowYear, maxWindowYear);
+}
+
+/** Add the incidences read by loadFromFile to the added lists of
+ *  actorMovies and movieCast, leaving the built lists as they are.
+ *  Movies past baseMovies are renumbered in order of release year
+ */
+void ActorGraph::addIncidence()
+{
+    incidence_vector added;   // <actor id, movie id> of every added list
+    incidence_vector byMovie; // same incidences keyed by movie instead
+    vector<int> newId(movieById.size() - baseMovies); // added movie id after renumbering
+    int movieId;
+
+    // only the added lists are decoded; the built lists stay untouched
+    actorMovies.addedPairs(added);
+
+    /** added movies are kept in year order after the built ones, so the
+     *  year window is one range in each
+     */
+    stable_sort(movieById.begin() + baseMovies, movieById.end(), releasedBefore);
+
+    for(unsigned int i = baseMovies; i < movieById.size(); ++i)
+    {
+        newId[movieById[i]->getId() - baseMovies] = i;
+        movieById[i]->setId(i);
+    }
+
+    for(incidence& inc : added)
+        if(inc.second >= baseMovies) inc.second = newId[inc.second - baseMovies];
+
+    for(incidence& inc : newIncidences)
+    {
+        // an actor newly listed again in a built movie is already there
+        if(inc.second < baseMovies
+           && actorMovies.range(inc.first, inc.second, inc.second + 1).next(movieId))
+            continue;
+
+        if(inc.second >= baseMovies) inc.second = newId[inc.second - baseMovies];
+        added.push_back(inc);
+    }
+
+    newIncidences = incidence_vector();
+
+    byMovie.reserve(added.size());
+    for(incidence& inc : added)
+        byMovie.push_back(incidence(inc.second, inc.first));
+
+    thread castBuild([&]() { movieCast.buildAdded(movieById.size(), byMovie); });
+    actorMovies.buildAdded(actorById.size(), added);
+    castBuild.join();
+
+    // added movie ids changed, so find the year window's range again
+    setYearWindow(minWindowYear, maxWindowYear);
 }
 
-/** Update the actor and movie archive as necessary */
-void ActorGraph::updateGraph(Actor* actor, Movie* movie)
+/** Only use movies released from minYear to maxYear (inclusive) in
+ *  following shortest path and MST queries. Call after loadFromFile.
+ */
+void ActorGraph::setYearWindow(int minYear, int maxYear)
+{
+    // kept so the range can be found again after movies are renumbered
+    minWindowYear = minYear;
+    maxWindowYear = maxYear;
+
+    // built and added movies are each sorted by year, so the window is
+    // one range of ids in each
+    auto yearBelow = [](Movie* movie, int year) { return movie->getMovieYear() < year; };
+    auto yearAbove = [](int year, Movie* movie) { return year < movie->getMovieYear(); };
+    auto builtEnd = movieById.begin() + baseMovies;
+
+    windowStart = lower_bound(movieById.begin(), builtEnd, minYear, yearBelow)
+                  - movieById.begin();
+    windowEnd = max(windowStart, (int)(upper_bound(movieById.begin(), builtEnd,
+                                                   maxYear, yearAbove)
+                                       - movieById.begin()));
+
+    addedStart = lower_bound(builtEnd, movieById.end(), minYear, yearBelow)
+                 - movieById.begin();
+    addedEnd = max(addedStart, (int)(upper_bound(builtEnd, movieById.end(),
+                                                 maxYear, yearAbove)
+                                     - movieById.begin()));
+}
+
+/** check if movie is inside the current year window */
+bool ActorGraph::inWindow(Movie* movie)
+{
+    return (movie->getId() >= windowStart && movie->getId() < windowEnd)
+           || (movie->getId() >= addedStart && movie->getId() < addedEnd);
+}
+
+/** Only accept paths of at most hops movies and total strength of at
+ *  most strength in following shortest path queries. -1 for no bound
+ */
+void ActorGraph::setSearchBounds(int hops, int strength)
+{
+    maxHops = hops;
+    maxStrength = strength;
+}
+
+/** Answer following shortest path queries on num worker processes
+ *  forked from this one. 1 answers them in this process. A worker that
+ *  spends over timeout seconds on one chunk of pairs is restarted
+ *  (0: no limit)
+ */
+void ActorGraph::setWorkers(int num, int timeout)
+{
+    numWorkers = max(1, num);
+    workerTimeout = max(0, timeout);
+}
+
+/** Write the num shortest simple paths of each pair in following
+ *  queries, shortest first. 1 writes only the shortest path
+ */
+void ActorGraph::setPathCount(int num)
 {
-    /** check if actor and/or movie must be updated */
-    actor->updateCollection(movie);
-    movie->updateCast(actor);
+    numPaths = max(1, num);
 }
 
 /** write shortest path for each pair of actors
-*  in pairs file -- initial call.
+*  in pairs file -- initial call. Returns false if the worker processes
+*  gave up on some pairs
 **/
-void ActorGraph::writeShortestPaths(istream& allPairs, ostream& pathsFile)
+bool ActorGraph::writeShortestPaths(istream& allPairs, ostream& pathsFile)
 {
     string currLine;
     string trash;
     string originActor;
     string destinationActor;
+    PairBatch batch;             // every pair, with ids resolved
 
     getline(allPairs, trash);    // go past header
     getline(allPairs, currLine); // wil be EOF if no pairs in file
 
     // check for no pairs input
-    if(allPairs.eof()) return;
+    if(allPairs.eof()) return true;
 
     // reset to beginning
     allPairs.clear();
@@ -192,16 +505,68 @@ void ActorGraph::writeShortestPaths(istream& allPairs, ostream& pathsFile)
     // write header to file
     pathsFile << "(actor)--[movie#@year]-->(actor)--..." << endl;
 
-    // find and write shortest path for all pairs
+    // read all pairs, then resolve all their names in one batch
     while(!allPairs.eof())
     {
         getOriginAndDest(originActor, destinationActor, allPairs);
+        batch.origins.push_back(originActor);
+        batch.destinations.push_back(destinationActor);
+    }
+
+    names.findAll(batch.origins, batch.origIds);
+    names.findAll(batch.destinations, batch.destIds);
+
+    if(numWorkers <= 1)
+    {
+        writePairPaths(batch, 0, batch.origins.size(), pathsFile, cerr);
+        return true;
+    }
+
+    /** workers are forked now, so they share the loaded graph and the
+     *  resolved pairs; only chunk numbers and results cross the sockets
+     */
+    WorkerPool pool(numWorkers, workerTimeout);
 
+    return pool.run(batch.origins.size(),
+                    [&](int begin, int end, ostream& out, ostream& err)
+                    { writePairPaths(batch, begin, end, out, err); },
+                    pathsFile, cerr);
+}
+
+/** find and write the path of pairs [begin, end) of batch. Unknown
+ *  actors and paths out of bounds are reported to err
+ */
+void ActorGraph::writePairPaths(const PairBatch& batch, int begin, int end,
+                                ostream& pathsFile, ostream& err)
+{
+    // find and write shortest path for all pairs
+    for(int i = begin; i < end; ++i)
+    {
         /** /*
-        cout << "Finding shortest path between " << originActor << " and "
-             << destinationActor << endl;
+        cout << "Finding shortest path between " << batch.origins[i] << " and "
+             << batch.destinations[i] << endl;
         //*/
-        getShortestPath(originActor, destinationActor, pathsFile);
+
+        // an unknown actor has no path to anyone; nothing is written
+        if(batch.origIds[i] == NameIndex::UNKNOWN
+           || batch.destIds[i] == NameIndex::UNKNOWN)
+        {
+            err << "Unknown actor: "
+                << (batch.origIds[i] == NameIndex::UNKNOWN ? batch.origins[i]
+                                                           : batch.destinations[i])
+                << endl;
+            continue;
+        }
+
+        Actor* origin = actorById[batch.origIds[i]];
+        Actor* destination = actorById[batch.destIds[i]];
+        bool found = numPaths > 1 ? writeTopPaths(origin, destination, pathsFile)
+                                  : findPath(origin, destination, pathsFile);
+
+        // nothing is written either when no path fits the bounds
+        if(!found && (maxHops >= 0 || maxStrength >= 0))
+            err << "No path within bound: " << batch.origins[i] << " -> "
+                << batch.destinations[i] << endl;
     }
 }
 
@@ -217,20 +582,31 @@ void ActorGraph::getOriginAndDest(string& orig, string& dest, istream& currLine)
     if(currLine.peek() == EOF) currLine.get();
 }
 
-/** find shortest path from actor A to B. Writes a formatted path to a file */
-void ActorGraph::getShortestPath(string& orig, string& dest, ostream& pathsFile)
+/** find shortest path from actor A to B within the search bounds.
+ *  Writes a formatted path to a file. Returns false if there is none
+ */
+bool ActorGraph::getShortestPath(Actor* origAct, Actor* destAct, ostream& pathsFile)
 {
-    Actor* origAct = actors.find(orig)->second;
-    Actor* destAct = actors.find(dest)->second;
     Actor* curr = nullptr; // current working actor in graph
     int recorded = 0; // number of nodes modified
     int distCheck; // current working distance from source
+    int movieId;   // id of movie decoded from current actor's movies
+    int actorId;   // id of actor decoded from current movie's cast
+    int limit = maxStrength; // paths longer than this are pruned (-1: no bound)
     bool hasPath = false;
 
+    // hops and strength are different measures; track both per partial path
+    if(weighted && maxHops >= 0)
+        return getHopBoundedPath<CustomWeight>(origAct, destAct, pathsFile);
+
+    // unweighted: every movie has strength 1, so hops are the distance
+    if(maxHops >= 0 && (limit < 0 || maxHops < limit))
+        limit = maxHops;
+
     // initial setup before Dijkstras; pushing origin to queue
     origAct->setDist(0);
     pq.push(origAct);
-    processed.insert(actor(origAct->getName(), origAct));
+    processed.insert(origAct);
 
     /** run Dijkstras to find shortest path from origin actor to dest actor */
     while(!pq.empty())
@@ -251,35 +627,44 @@ void ActorGraph::getShortestPath(string& orig, string& dest, ostream& pathsFile)
         {
             // Mark as processed so it's not visited later. Record modification
             curr->wasProcessed = true;
-            processed.insert(actor(curr->getName(), curr));
+            processed.insert(curr);
 
-            // travel through each edge for actor (movie in collection)
-            for(movieVal movieItr : curr->movies)
+            // travel through each edge for actor (movies inside year window)
+            IncidenceList::Cursor movieItr =
+                    actorMovies.range(curr->getId(), windowStart, windowEnd,
+                                      addedStart, addedEnd);
+            while(movieItr.next(movieId))
             {
+                Movie* movie = movieById[movieId];
+
                 // for each destination from edge (cast in movie)
-                for(actorVal actorItr : movieItr.second->cast)
+                IncidenceList::Cursor castItr = movieCast.list(movieId);
+                while(castItr.next(actorId))
                 {
+                    Actor* next = actorById[actorId];
+
                     // check if current actor has been completely processed
-                    if(actorItr.second->wasProcessed) continue;
+                    if(next->wasProcessed) continue;
 
                     // get this paths distance from origin to current actor
-                    distCheck = curr->getDist() + movieItr.second->getStrength();
+                    distCheck = curr->getDist() + movie->getStrength();
+
+                    // past the bound; never queued, so the search dies out early
+                    if(limit >= 0 && distCheck > limit) continue;
 
                     // if infinite dist or better dist found, update
-                    if(actorItr.second->getDist() < 0 ||
-                            distCheck < actorItr.second->getDist())
+                    if(next->getDist() < 0 || distCheck < next->getDist())
                     {
                         // remember actor that got us here
-                        actorItr.second->setPrev(curr);
-                        actorItr.second->setDist(distCheck);
+                        next->setPrev(curr);
+                        next->setDist(distCheck);
                         // dest actor remembers movie connecting them
-                        actorItr.second->setEdge(movieItr.second);
+                        next->setEdge(movie);
 
-                        pq.push(actorItr.second);
+                        pq.push(next);
 
                         // record that this node was modified
-                        processed.insert(actor(actorItr.second->getName(),
-                                          actorItr.second));
+                        processed.insert(next);
                     }
                 }
             }
@@ -298,111 +683,1138 @@ void ActorGraph::getShortestPath(string& orig, string& dest, ostream& pathsFile)
     writePathToDest(pathsFile);
 
     // reset processed nodes for another search
-    for(actor record : processed)
+    for(Actor* record : processed)
     {
-        record.second->wasProcessed = false;
-        record.second->setDist(-1);
-        record.second->setPrev(nullptr);
+        record->wasProcessed = false;
+        record->setDist(-1);
+        record->setPrev(nullptr);
     }
 
     // reset priority queue for a new call to find shortest path
-    pq = priority_queue<Actor*, vector<Actor*>, ActCompare>();
-    processed = unordered_map<string, Actor*>();
+    pq = actor_pq();
+    processed = hash_table();
+
+    return hasPath;
 }
 
-/** write shortest path from origin to destination to output file */
-void ActorGraph::writePathToDest(ostream & out)
+/** find the lowest weight path from actor A to B using at most maxHops
+ *  movies, each weighing Weight::weight. Writes a formatted path to a
+ *  file. Returns false if there is none
+ *
+ *  An actor can be worth reaching again at a higher weight if it takes
+ *  fewer movies, so partial paths (labels) are queued instead of actors.
+ *  Labels pop in order of weight; each actor remembers (in its dist) the
+ *  fewest hops it was expanded with, and only labels with fewer hops than
+ *  that are expanded again.
+ */
+template <class Weight>
+bool ActorGraph::getHopBoundedPath(Actor* origAct, Actor* destAct,
+                                   ostream& pathsFile)
 {
-    while(!path.empty())
+    int movieId;   // id of movie decoded from current actor's movies
+    int actorId;   // id of actor decoded from current movie's cast
+    int found = -1; // label reaching destAct, if any
+
+    labels.push_back(PathLabel{origAct, nullptr, 0, 0, -1});
+    labelPq.push(label_key(make_pair(0, 0), 0));
+
+    while(!labelPq.empty())
     {
-        // check if last node
-        if(path.size() == 1)
+        int currLabel = labelPq.top().second;
+        PathLabel curr = labels[currLabel];
+        labelPq.pop();
+
+        // an earlier (no longer) path reached this actor in no more hops
+        if(curr.actor->getDist() >= 0 && curr.actor->getDist() <= curr.hops)
+            continue;
+
+        // remember fewest hops expanded with. Record modification
+        curr.actor->setDist(curr.hops);
+        processed.insert(curr.actor);
+
+        // first label of destination popped has the lowest weight
+        if(curr.actor == destAct)
         {
-            out << "(" << path.top()->getName() << ")\n";
-            path.pop();
+            found = currLabel;
             break;
         }
 
-        // copy paste nodes in between
-        out << "(" << path.top()->getName() << ")--[";
+        // out of hops; this path cannot be extended
+        if(curr.hops == maxHops) continue;
 
-        path.pop();
+        IncidenceList::Cursor movieItr =
+                actorMovies.range(curr.actor->getId(), windowStart, windowEnd,
+                                  addedStart, addedEnd);
+        while(movieItr.next(movieId))
+        {
+            Movie* movie = movieById[movieId];
+            int distCheck = curr.dist + Weight::weight(movie);
 
-        out << path.top()->getEdge()->getMovieName()
-            << "#@" << path.top()->getEdge()->getMovieYear()
-            << "]-->";
+            // past the weight bound
+            if(maxStrength >= 0 && distCheck > maxStrength) continue;
+
+            IncidenceList::Cursor castItr = movieCast.list(movieId);
+            while(castItr.next(actorId))
+            {
+                Actor* next = actorById[actorId];
+
+                // already expanded with no more hops than this path would have
+                if(next->getDist() >= 0 && next->getDist() <= curr.hops + 1)
+                    continue;
+
+                labels.push_back(PathLabel{next, movie, distCheck,
+                                           curr.hops + 1, currLabel});
+                labelPq.push(label_key(make_pair(distCheck, curr.hops + 1),
+                                       labels.size() - 1));
+            }
+        }
+    }
+
+    // follow labels back to origin. Lowest strength path has no repeated actor
+    for(int l = found; l >= 0; l = labels[l].prev)
+    {
+        labels[l].actor->setEdge(labels[l].movie);
+        path.push(labels[l].actor);
     }
 
+    writePathToDest(pathsFile);
+
+    // reset processed nodes for another search
+    for(Actor* record : processed)
+        record->setDist(-1);
+
+    processed = hash_table();
+    labels.clear();
+    labelPq = label_pq();
+
+    return found >= 0;
 }
 
-/** Write a Minimum Spanning Tree to mstOutFile, including header, shortest weighted paths, num of actors and movies
- *  and total edge weight.
+/** Use the search specialized on weights and frontier in following
+ *  shortest path queries. Returns false, keeping the current search,
+ *  if the frontier cannot order those weights. Each later load selects
+ *  it again, so the bucket span covers the new movies
  */
-void ActorGraph::writeMST(ostream& mstOutFile)
+bool ActorGraph::selectKernel(WeightPolicy weights, FrontierPolicy frontier)
 {
-    // Initializing variables to hold edges, actors, and total weight/actors/edges.
-    Movie* currEdge;
-    Actor* act1;
-    Actor* act2;
-    int numEdges = 0;
-    int numActs = 0;
-    int weightTotal = 0;
+    search_kernel selected = nullptr;
+    int minWeight = 1;
+    int maxWeight = 1;
 
-    // TODO: single node case
+    if(frontier == GENERIC_SEARCH)
+    {
+        kernel = nullptr;
+        return true;
+    }
 
-    // write header of mst file
-    mstOutFile << "(actor)<--[movie#@year]-->(actor)\n";
+    // weight range decides the bucket count, and whether buckets work at all
+    for(Movie* movie : movieById)
+    {
+        int w = weights == UNIT_WEIGHT ? UnitWeight::weight(movie)
+              : weights == YEAR_WEIGHT ? YearWeight::weight(movie)
+              : CustomWeight::weight(movie);
+
+        minWeight = min(minWeight, w);
+        maxWeight = max(maxWeight, w);
+    }
+
+    if(weights == UNIT_WEIGHT) selected = kernelFor<UnitWeight>(frontier);
+    else if(weights == YEAR_WEIGHT) selected = kernelFor<YearWeight>(frontier);
+    else selected = kernelFor<CustomWeight>(frontier);
+
+    // negative weights would land behind the bucket being popped
+    if(!selected || (frontier == BUCKET_FRONTIER && minWeight < 0))
+        return false;
+
+    kernel = selected;
+    kernelWeights = weights;
+    kernelFrontier = frontier;
+    bucketSpan = maxWeight + 1;
+    return true;
+}
 
-    // While loop to connect actors until we have a connected path with no cycles.
-    while(numEdges != numActors - 1)
+/** get the searchKernel instantiation for Weight and frontier, or
+ *  nullptr if that frontier cannot order Weight's distances
+ */
+template <class Weight>
+search_kernel ActorGraph::kernelFor(FrontierPolicy frontier)
+{
+    switch(frontier)
     {
-        // Getting the minimum-weight movie.
-        currEdge = ordEdges.top();
-        ordEdges.pop();
+        case FIFO_FRONTIER:
+            // arrival order is distance order only if every movie costs 1
+            return Weight::UNIT ? &ActorGraph::searchKernel<Weight, FifoFrontier>
+                                : nullptr;
+        case HEAP_FRONTIER:
+            return &ActorGraph::searchKernel<Weight, HeapFrontier>;
+        case BUCKET_FRONTIER:
+            return &ActorGraph::searchKernel<Weight, BucketFrontier>;
+        default:
+            return nullptr;
+    }
+}
 
-        // check each actor for currEdge movie
-        auto itr = currEdge->cast.begin();
-        while(true)                          //the magic happens past this point//
-        {
-            //Get the (itr)th actor in the cast
-            act1 = itr++->second;
+/** find path from actor A to B with the selected search, within the
+ *  search bounds. Writes a formatted path to a file. Returns false if
+ *  there is none
+ */
+bool ActorGraph::findPath(Actor* origAct, Actor* destAct, ostream& pathsFile)
+{
+    // original search, which also handles every bound itself
+    if(!kernel)
+        return getShortestPath(origAct, destAct, pathsFile);
+
+    // hops and weight are different measures; needs the label search
+    if(maxHops >= 0 && kernelWeights == YEAR_WEIGHT)
+        return getHopBoundedPath<YearWeight>(origAct, destAct, pathsFile);
+    if(maxHops >= 0 && kernelWeights == CUSTOM_WEIGHT)
+        return getHopBoundedPath<CustomWeight>(origAct, destAct, pathsFile);
+
+    if(!(this->*kernel)(origAct->getId(), destAct->getId(), searchState))
+        return false;
 
-            // if reached last actor, get out
-            if(itr == currEdge->cast.end())
-                break;
+    writeStatePath(searchState, destAct->getId(), pathsFile);
+    return true;
+}
 
-            //Get the (itr+1)th actor in the cast
-            act2 = itr->second;
+/** Shortest path search specialized on a weight and frontier policy.
+ *  Leaves the path to dest in state. Returns false if there is none
+ */
+template <class Weight, class Frontier>
+bool ActorGraph::searchKernel(int orig, int dest, SearchState& state)
+{
+    Frontier& frontier = Frontier::in(state);
+    int limit = maxStrength; // paths longer than this are pruned (-1: no bound)
+    int movieId;             // id of movie decoded from current actor's movies
+    int actorId;             // id of actor decoded from current movie's cast
 
-            // keep track of number of nodes inserted
-            if(!act1->wasProcessed) ++numActs;
-            if(!act2->wasProcessed) ++numActs;
+    // unit weights: hops are the distance
+    if(Weight::UNIT && maxHops >= 0 && (limit < 0 || maxHops < limit))
+        limit = maxHops;
 
-            // if actors are in the same set, go to next actor in cast. Prevents cycle.
-            if(setFind(act1) == setFind(act2))
-                continue;
+    state.clear(actorById.size());
+    frontier.clear(bucketSpan);
 
-            // Union the disjoint sets.
-            setUnion(act1, act2);
+    state.reach(orig, 0, -1, -1);
+    frontier.push(orig, 0);
 
-            // We mark both actors as processed. Prevents counting actors twice.
-            act1->wasProcessed = act2->wasProcessed = true;
+    if(orig == dest) return true;
 
-            // At this point, we connected two actors, so increase edge and weight total.
-            ++numEdges;
-            weightTotal += currEdge->getStrength();
+    while(!frontier.empty())
+    {
+        int curr = frontier.pop();
+
+        // stale entry of an actor that was queued again with a lower dist
+        if(state.done[curr]) continue;
+
+        // popped node is done node; its path is the shortest
+        if(curr == dest) return true;
+
+        state.done[curr] = 1;
+        int currDist = state.dist[curr];
+
+        // travel through each edge for actor (movies inside year window)
+        IncidenceList::Cursor movieItr =
+                actorMovies.range(curr, windowStart, windowEnd,
+                                  addedStart, addedEnd);
+        while(movieItr.next(movieId))
+        {
+            int distCheck = currDist + Weight::weight(movieById[movieId]);
 
-            // write edge to mstOutFile
-            mstOutFile << "(" << act1->getName() << ")<--["
-                       << currEdge->getMovieName() << "#@"
-                       << currEdge->getMovieYear() << "]-->("
-                       << act2->getName() << ")\n";
+            // past the bound; never queued, so the search dies out early
+            if(limit >= 0 && distCheck > limit) continue;
+
+            // for each destination from edge (cast in movie)
+            IncidenceList::Cursor castItr = movieCast.list(movieId);
+            while(castItr.next(actorId))
+            {
+                if(state.done[actorId]) continue;
+
+                // if infinite dist or better dist found, update
+                if(state.dist[actorId] < 0 || distCheck < state.dist[actorId])
+                {
+                    state.reach(actorId, distCheck, curr, movieId);
+
+                    // first arrival is already shortest in a FIFO frontier
+                    if(Frontier::EXIT_ON_REACH && actorId == dest) return true;
+
+                    frontier.push(actorId, distCheck);
+                }
+            }
         }
     }
-    // Write total number of actors, edges, and total weight to mstOutfile.
-    mstOutFile << "#NODE CONNECTED: " << numActs << endl
-               << "#EDGE CHOSEN: " << numEdges << endl
-               << "TOTAL EDGE WEIGHTS: " << weightTotal << endl;
+
+    return false;
+}
+
+/** Write the path to dest left in state by searchKernel */
+void ActorGraph::writeStatePath(SearchState& state, int dest, ostream& out)
+{
+    vector<int> actorIds; // path from dest back to origin
+
+    for(int curr = dest; curr >= 0; curr = state.prevActor[curr])
+        actorIds.push_back(curr);
+
+    // same format as writePathToDest, from origin to dest
+    for(int i = actorIds.size() - 1; i > 0; --i)
+    {
+        Movie* movie = movieById[state.prevMovie[actorIds[i - 1]]];
+
+        out << "(" << names.getName(actorIds[i]) << ")--["
+            << movie->getMovieName() << "#@" << movie->getMovieYear()
+            << "]-->";
+    }
+
+    out << "(" << names.getName(dest) << ")\n";
+}
+
+/** weight of movie under the selected search: its weight policy if a
+ *  kernel is selected, else its strength
+ */
+int ActorGraph::movieWeight(Movie* movie)
+{
+    if(kernel && kernelWeights == UNIT_WEIGHT) return UnitWeight::weight(movie);
+    if(kernel && kernelWeights == YEAR_WEIGHT) return YearWeight::weight(movie);
+    return CustomWeight::weight(movie);
+}
+
+/** Fill destTree with the shortest path from every actor to dest, by
+ *  pathWeight. prevActor of an actor is the next actor on its way to
+ *  dest. Also fills treeHops, and destHops if hops are bounded
+ */
+void ActorGraph::buildDestTree(int dest)
+{
+    BucketFrontier& frontier = destTree.bucket;
+    int span = 1;  // largest movie weight + 1
+    int movieId;   // id of movie decoded from current actor's movies
+    int actorId;   // id of actor decoded from current movie's cast
+
+    pathWeight.resize(movieById.size());
+    unitPaths = true;
+
+    for(Movie* movie : movieById)
+    {
+        int w = movieWeight(movie);
+
+        pathWeight[movie->getId()] = w;
+        unitPaths = unitPaths && w == 1;
+        span = max(span, w + 1);
+    }
+
+    destTree.clear(actorById.size());
+    frontier.clear(span);
+    movieExpanded.assign(movieById.size(), 0);
+    treeHops.resize(actorById.size());
+
+    destTree.reach(dest, 0, -1, -1);
+    treeHops[dest] = 0;
+    frontier.push(dest, 0);
+
+    // edges are undirected, so a search from dest gives distances to it
+    while(!frontier.empty())
+    {
+        int curr = frontier.pop();
+
+        if(destTree.done[curr]) continue;
+        destTree.done[curr] = 1;
+
+        IncidenceList::Cursor movieItr =
+                actorMovies.range(curr, windowStart, windowEnd,
+                                  addedStart, addedEnd);
+        while(movieItr.next(movieId))
+        {
+            // first cast member settled is the closest; the rest gain nothing
+            if(movieExpanded[movieId]) continue;
+            movieExpanded[movieId] = 1;
+
+            int distCheck = destTree.dist[curr] + pathWeight[movieId];
+
+            IncidenceList::Cursor castItr = movieCast.list(movieId);
+            while(castItr.next(actorId))
+            {
+                if(destTree.done[actorId]) continue;
+
+                if(destTree.dist[actorId] < 0 || distCheck < destTree.dist[actorId])
+                {
+                    destTree.reach(actorId, distCheck, curr, movieId);
+                    treeHops[actorId] = treeHops[curr] + 1;
+                    frontier.push(actorId, distCheck);
+                }
+            }
+        }
+    }
+
+    // unit weights bound hops through the weight; others need hop counts
+    if(maxHops < 0 || unitPaths) return;
+
+    FifoFrontier& queue = destTree.fifo;
+
+    destHops.assign(actorById.size(), -1);
+    movieExpanded.assign(movieById.size(), 0);
+    queue.clear(0);
+
+    destHops[dest] = 0;
+    queue.push(dest, 0);
+
+    while(!queue.empty())
+    {
+        int curr = queue.pop();
+
+        IncidenceList::Cursor movieItr =
+                actorMovies.range(curr, windowStart, windowEnd,
+                                  addedStart, addedEnd);
+        while(movieItr.next(movieId))
+        {
+            if(movieExpanded[movieId]) continue;
+            movieExpanded[movieId] = 1;
+
+            IncidenceList::Cursor castItr = movieCast.list(movieId);
+            while(castItr.next(actorId))
+            {
+                if(destHops[actorId] >= 0) continue;
+
+                destHops[actorId] = destHops[curr] + 1;
+                queue.push(actorId, destHops[actorId]);
+            }
+        }
+    }
+}
+
+/** find the shortest path from spur to the destination of destTree
+ *  that avoids blocked actors, leaves spur through none of blockedEdges
+ *  and has at most hopBudget movies and weightBudget weight (-1: no
+ *  bound). An A* search on labels guided by the tree distances, which
+ *  stops at the first label whose tree path is allowed. false if there
+ *  is none
+ */
+bool ActorGraph::findSpurPath(int spur, const vector<path_edge>& blockedEdges,
+                              int hopBudget, int weightBudget, ActorPath& path)
+{
+    SearchState& state = searchState;
+    bool byHops = hopBudget >= 0; // labels differ by hops, not only by weight
+    int movieId;
+    int actorId;
+    int joint = -1; // label where the search joins its tree path
+
+    path.actors.clear();
+    path.movies.clear();
+
+    if(destTree.dist[spur] < 0) return false;
+    if(weightBudget >= 0 && destTree.dist[spur] > weightBudget) return false;
+    if(byHops && (destHops[spur] < 0 || destHops[spur] > hopBudget)) return false;
+
+    if(byHops && spurHops.size() != actorById.size())
+        spurHops.assign(actorById.size(), 0);
+
+    /** tree distances never overestimate, since blocking actors and edges
+     *  only makes paths longer. state.done marks expanded actors, and
+     *  spurHops the fewest hops they were expanded with
+     */
+    state.clear(actorById.size());
+    labels.clear();
+    labelPq = label_pq();
+
+    state.reach(spur, 0, -1, -1);
+    labels.push_back(PathLabel{actorById[spur], nullptr, 0, 0, -1});
+    labelPq.push(label_key(make_pair(destTree.dist[spur], 0), 0));
+
+    while(joint < 0 && !labelPq.empty())
+    {
+        int currLabel = labelPq.top().second;
+        int bound = labelPq.top().first.first; // least f queued
+        PathLabel curr = labels[currLabel];
+        int currId = curr.actor->getId();
+        labelPq.pop();
+
+        // an earlier (no longer) label expanded this actor in no more hops
+        if(state.done[currId] && (!byHops || spurHops[currId] <= curr.hops))
+            continue;
+
+        // nothing queued can beat curr's tree path, so take it if allowed
+        if(treePathAllowed(currLabel, blockedEdges, hopBudget))
+        {
+            joint = currLabel;
+            break;
+        }
+
+        state.done[currId] = 1;
+        if(byHops) spurHops[currId] = curr.hops;
+
+        IncidenceList::Cursor movieItr =
+                actorMovies.range(currId, windowStart, windowEnd,
+                                  addedStart, addedEnd);
+        while(joint < 0 && movieItr.next(movieId))
+        {
+            int distCheck = curr.dist + pathWeight[movieId];
+
+            IncidenceList::Cursor castItr = movieCast.list(movieId);
+            while(joint < 0 && castItr.next(actorId))
+            {
+                if(blockedActor[actorId] & ON_ROOT) continue;
+                if(destTree.dist[actorId] < 0) continue;
+
+                int f = distCheck + destTree.dist[actorId];
+
+                if(weightBudget >= 0 && f > weightBudget) continue;
+
+                if(byHops)
+                {
+                    if(state.done[actorId] && spurHops[actorId] <= curr.hops + 1)
+                        continue;
+
+                    // cannot reach dest in the hops left
+                    if(destHops[actorId] < 0
+                       || curr.hops + 1 + destHops[actorId] > hopBudget)
+                        continue;
+                }
+                else if(state.done[actorId]
+                        || (state.dist[actorId] >= 0 && distCheck >= state.dist[actorId]))
+                    continue;
+
+                // the edges other found paths leave the spur through
+                if(currId == spur && (blockedActor[actorId] & EDGE_TARGET)
+                   && find(blockedEdges.begin(), blockedEdges.end(),
+                           path_edge(movieId, actorId)) != blockedEdges.end())
+                    continue;
+
+                if(state.dist[actorId] < 0 || distCheck < state.dist[actorId])
+                    state.reach(actorId, distCheck, currId, movieId);
+
+                labels.push_back(PathLabel{actorById[actorId], movieById[movieId],
+                                           distCheck, curr.hops + 1, currLabel});
+                int nextLabel = labels.size() - 1;
+
+                /** nothing queued is below bound, so a label reached at
+                 *  bound with an allowed tree path ends the search now
+                 */
+                if(f == bound && treePathAllowed(nextLabel, blockedEdges, hopBudget))
+                    joint = nextLabel;
+                else
+                    labelPq.push(label_key(make_pair(f, curr.hops + 1), nextLabel));
+            }
+        }
+    }
+
+    if(joint < 0) return false;
+
+    int jointId = labels[joint].actor->getId();
+    path.dist = labels[joint].dist + destTree.dist[jointId];
+
+    // searched part, walked back from the joint and flipped to run from spur
+    for(int l = joint; l >= 0; l = labels[l].prev)
+    {
+        path.actors.push_back(labels[l].actor->getId());
+        if(labels[l].prev >= 0) path.movies.push_back(labels[l].movie->getId());
+    }
+
+    reverse(path.actors.begin(), path.actors.end());
+    reverse(path.movies.begin(), path.movies.end());
+
+    // then the tree path from the joint on
+    for(int curr = jointId; destTree.prevActor[curr] >= 0;
+        curr = destTree.prevActor[curr])
+    {
+        path.movies.push_back(destTree.prevMovie[curr]);
+        path.actors.push_back(destTree.prevActor[curr]);
+    }
+
+    return true;
+}
+
+/** check if the tree path from the actor of label, reached by the spur
+ *  search, avoids blocked actors and edges and the searched path to it,
+ *  and keeps the whole path within hopBudget movies (-1: no bound)
+ */
+bool ActorGraph::treePathAllowed(int label, const vector<path_edge>& blockedEdges,
+                                 int hopBudget)
+{
+    int curr = labels[label].actor->getId();
+    bool allowed = true;
+
+    if(hopBudget >= 0 && labels[label].hops + treeHops[curr] > hopBudget)
+        return false;
+
+    // only the spur's own first edge can be blocked
+    if(labels[label].prev < 0 && destTree.prevActor[curr] >= 0
+       && (blockedActor[destTree.prevActor[curr]] & EDGE_TARGET)
+       && find(blockedEdges.begin(), blockedEdges.end(),
+               path_edge(destTree.prevMovie[curr], destTree.prevActor[curr]))
+          != blockedEdges.end())
+        return false;
+
+    // the whole path must stay simple; mark the searched chain once
+    for(int l = label; l >= 0; l = labels[l].prev)
+        blockedActor[labels[l].actor->getId()] |= ON_CHAIN;
+
+    for(int next = destTree.prevActor[curr]; allowed && next >= 0;
+        next = destTree.prevActor[next])
+        if(blockedActor[next] & (ON_ROOT | ON_CHAIN)) allowed = false;
+
+    for(int l = label; l >= 0; l = labels[l].prev)
+        blockedActor[labels[l].actor->getId()] &= ~ON_CHAIN;
+
+    return allowed;
+}
+
+/** find and write up to numPaths shortest simple paths from actor A
+ *  to B in order of length (Yen's algorithm). Returns false if there
+ *  is none within the search bounds
+ */
+bool ActorGraph::writeTopPaths(Actor* origAct, Actor* destAct, ostream& pathsFile)
+{
+    vector<ActorPath> found;  // shortest paths so far, in order
+    set<ActorPath> candidates; // spur paths not taken yet, shortest first
+    vector<path_edge> blockedEdges; // edges found paths leave the spur through
+    ActorPath spurPath;
+    int orig = origAct->getId();
+    int limit = maxStrength; // path weight bound (-1: none)
+    int hopLimit = maxHops;  // path hop bound (-1: none)
+
+    // distances to dest guide every spur search of this pair
+    buildDestTree(destAct->getId());
+    if(destTree.dist[orig] < 0) return false;
+
+    // unit weights: hops are the weight, so one bound covers both
+    if(unitPaths && hopLimit >= 0)
+    {
+        if(limit < 0 || hopLimit < limit) limit = hopLimit;
+        hopLimit = -1;
+    }
+
+    if(blockedActor.size() != actorById.size())
+        blockedActor.assign(actorById.size(), 0);
+
+    // spur searches only return paths within both bounds
+    if(!findSpurPath(orig, blockedEdges, hopLimit, limit, spurPath)) return false;
+    spurPath.deviation = 0;
+    candidates.insert(spurPath);
+
+    while(found.size() < (unsigned int)numPaths && !candidates.empty())
+    {
+        found.push_back(*candidates.begin());
+        candidates.erase(candidates.begin());
+
+        const ActorPath& last = found.back();
+
+        writeActorPath(last, pathsFile);
+
+        /** deviate from last at every actor but dest: keep the root before
+         *  the spur, and leave the spur through an edge no found path with
+         *  the same root uses. Spurs before last's own deviation were
+         *  already tried from the path it deviated from (Lawler)
+         */
+        int rootDist = 0;
+
+        for(int i = 0; i < last.deviation; ++i)
+            rootDist += pathWeight[last.movies[i]];
+
+        for(unsigned int i = last.deviation; i + 1 < last.actors.size(); ++i)
+        {
+            int spur = last.actors[i];
+
+            blockedEdges.clear();
+            for(const ActorPath& other : found)
+                if(other.actors.size() > i + 1
+                   && equal(last.actors.begin(), last.actors.begin() + i + 1,
+                            other.actors.begin())
+                   && equal(last.movies.begin(), last.movies.begin() + i,
+                            other.movies.begin()))
+                    blockedEdges.push_back(path_edge(other.movies[i],
+                                                     other.actors[i + 1]));
+
+            // the path stays simple: no going back through the root
+            for(unsigned int j = 0; j < i; ++j) blockedActor[last.actors[j]] = ON_ROOT;
+            for(const path_edge& edge : blockedEdges) blockedActor[edge.second] = EDGE_TARGET;
+
+            if(findSpurPath(spur, blockedEdges, hopLimit < 0 ? -1 : hopLimit - (int)i,
+                            limit < 0 ? -1 : limit - rootDist, spurPath))
+            {
+                ActorPath total;
+
+                total.dist = rootDist + spurPath.dist;
+                total.deviation = i;
+                total.actors.assign(last.actors.begin(), last.actors.begin() + i);
+                total.actors.insert(total.actors.end(), spurPath.actors.begin(),
+                                    spurPath.actors.end());
+                total.movies.assign(last.movies.begin(), last.movies.begin() + i);
+                total.movies.insert(total.movies.end(), spurPath.movies.begin(),
+                                    spurPath.movies.end());
+
+                candidates.insert(total);
+            }
+
+            for(unsigned int j = 0; j < i; ++j) blockedActor[last.actors[j]] = 0;
+            for(const path_edge& edge : blockedEdges) blockedActor[edge.second] = 0;
+
+            rootDist += pathWeight[last.movies[i]];
+        }
+
+        // only the shortest of the candidates can still be written
+        while(candidates.size() > numPaths - found.size())
+            candidates.erase(prev(candidates.end()));
+    }
+
+    return true;
+}
+
+/** Write a path found by writeTopPaths in the format of writePathToDest */
+void ActorGraph::writeActorPath(const ActorPath& path, ostream& out)
+{
+    for(unsigned int i = 0; i < path.movies.size(); ++i)
+    {
+        Movie* movie = movieById[path.movies[i]];
+
+        out << "(" << names.getName(path.actors[i]) << ")--["
+            << movie->getMovieName() << "#@" << movie->getMovieYear()
+            << "]-->";
+    }
+
+    out << "(" << names.getName(path.actors.back()) << ")\n";
+}
+
+/** write shortest path from origin to destination to output file */
+void ActorGraph::writePathToDest(ostream & out)
+{
+    while(!path.empty())
+    {
+        // check if last node
+        if(path.size() == 1)
+        {
+            out << "(" << names.getName(path.top()->getId()) << ")\n";
+            path.pop();
+            break;
+        }
+
+        // copy paste nodes in between
+        out << "(" << names.getName(path.top()->getId()) << ")--[";
+
+        path.pop();
+
+        out << path.top()->getEdge()->getMovieName()
+            << "#@" << path.top()->getEdge()->getMovieYear()
+            << "]-->";
+    }
+
+}
+
+/** Build the Minimum Spanning Tree with Kruskal's algorithm. Movies
+ *  added by later loads update it instead of rebuilding it
+ */
+void ActorGraph::buildMST()
+{
+    // Initializing variables to hold edges, actors, and number of edges.
+    Movie* currEdge;
+    Actor* act1;
+    Actor* act2;
+    int actorId; // id of actor decoded from currEdge's cast
+    int numEdges = 0;
+
+    if(hasMST) return;
+
+    // every actor is a node of the forest; edges are nodes between them
+    while(actorNode.size() < actorById.size())
+        actorNode.push_back(mstForest.addNode(INT_MIN, -1));
+
+    /** While loop to connect actors until we have a connected path with no cycles.
+     *  Stop early if movies run out (year window can leave actors unconnected).
+     */
+    while(numEdges != numActors - 1 && !ordEdges.empty())
+    {
+        // Getting the minimum-weight movie.
+        currEdge = ordEdges.top();
+        ordEdges.pop();
+
+        // movies outside the year window do not connect anyone
+        if(!inWindow(currEdge)) continue;
+
+        // check each actor for currEdge movie
+        IncidenceList::Cursor castItr = movieCast.list(currEdge->getId());
+
+        //Get the first actor in the cast (movies always have at least one)
+        castItr.next(actorId);
+        act1 = actorById[actorId];
+
+        //Get the next actor in the cast, until reached last actor
+        for(; castItr.next(actorId); act1 = act2) //the magic happens past this point//
+        {
+            act2 = actorById[actorId];
+
+            // if actors are in the same set, go to next actor in cast. Prevents cycle.
+            if(setFind(act1) == setFind(act2))
+                continue;
+
+            // Union the disjoint sets.
+            setUnion(act1, act2);
+
+            // At this point, we connected two actors, so keep the edge.
+            ++numEdges;
+            linkMSTEdge(act1, act2, currEdge);
+        }
+    }
+
+    // the disjoint sets live in the fields path searches use; reset them
+    for(Actor* actor : actorById)
+    {
+        actor->setPrev(nullptr);
+        actor->numBelow = 0;
+    }
+
+    hasMST = true;
+}
+
+/** Add an edge between act1 and act2 through movie to the MST, which
+ *  must not connect them yet
+ */
+void ActorGraph::linkMSTEdge(Actor* act1, Actor* act2, Movie* movie)
+{
+    int edge = mstForest.addNode(movie->getStrength(), mstEdges.size());
+
+    mstEdges.push_back(MSTEdge{act1, act2, movie});
+    mstForest.link(actorNode[act1->getId()], edge);
+    mstForest.link(edge, actorNode[act2->getId()]);
+    mstWeight += movie->getStrength();
+}
+
+/** Offer an edge between act1 and act2 through movie to the MST. It is
+ *  added if it joins two trees, or replaces the heaviest edge of the
+ *  cycle it closes if that edge is heavier
+ */
+void ActorGraph::insertMSTEdge(Actor* act1, Actor* act2, Movie* movie)
+{
+    int node1 = actorNode[act1->getId()];
+    int node2 = actorNode[act2->getId()];
+
+    // joins two trees, so it is always part of the MST
+    if(!mstForest.connected(node1, node2))
+    {
+        linkMSTEdge(act1, act2, movie);
+        return;
+    }
+
+    // closes a cycle; only its heaviest edge can be dropped
+    int edge = mstForest.pathMax(node1, node2);
+    if(mstForest.getValue(edge) <= movie->getStrength()) return;
+
+    MSTEdge& heaviest = mstEdges[mstForest.getTag(edge)];
+
+    mstForest.cut(actorNode[heaviest.act1->getId()], edge);
+    mstForest.cut(edge, actorNode[heaviest.act2->getId()]);
+    mstWeight += movie->getStrength() - heaviest.movie->getStrength();
+
+    // the dropped edge's node and slot now hold the new edge
+    heaviest = MSTEdge{act1, act2, movie};
+    mstForest.setValue(edge, movie->getStrength());
+    mstForest.link(node1, edge);
+    mstForest.link(edge, node2);
+}
+
+/** Offer the cast of every movie of the current load to the MST */
+void ActorGraph::updateMST()
+{
+    Actor* act1;
+    Actor* act2;
+    int actorId; // id of actor decoded from a movie's cast
+
+    // actors first seen in this load start as trees of their own
+    while(actorNode.size() < actorById.size())
+        actorNode.push_back(mstForest.addNode(INT_MIN, -1));
+
+    for(Movie* movie : loadedMovies)
+    {
+        // movies outside the year window do not connect anyone
+        if(!inWindow(movie)) continue;
+
+        /** a movie's cast is a clique of equal edges, so the chain through
+         *  the cast carries the same MST as the whole clique
+         */
+        IncidenceList::Cursor castItr = movieCast.list(movie->getId());
+
+        castItr.next(actorId);
+        act1 = actorById[actorId];
+
+        for(; castItr.next(actorId); act1 = act2)
+        {
+            act2 = actorById[actorId];
+            insertMSTEdge(act1, act2, movie);
+        }
+    }
+}
+
+/** Write a Minimum Spanning Tree to mstOutFile, including header, shortest weighted paths, num of actors and movies
+ *  and total edge weight.
+ */
+void ActorGraph::writeMST(ostream& mstOutFile)
+{
+    vector<int> order;           // edge slots by strength
+    vector<char> connected(actorById.size(), 0); // 1 if actor has an edge
+    int numActs = 0;
+
+    if(!hasMST) buildMST();
+
+    // Kruskal found edges lightest first; keep that order for added edges too
+    order.resize(mstEdges.size());
+    for(unsigned int i = 0; i < order.size(); ++i) order[i] = i;
+
+    stable_sort(order.begin(), order.end(), [this](int e1, int e2)
+                { return mstEdges[e1].movie->getStrength()
+                         < mstEdges[e2].movie->getStrength(); });
+
+    // write header of mst file
+    mstOutFile << "(actor)<--[movie#@year]-->(actor)\n";
+
+    for(int e : order)
+    {
+        MSTEdge& edge = mstEdges[e];
+
+        // keep track of number of nodes connected. Prevents counting actors twice.
+        if(!connected[edge.act1->getId()]) ++numActs;
+        if(!connected[edge.act2->getId()]) ++numActs;
+        connected[edge.act1->getId()] = connected[edge.act2->getId()] = 1;
+
+        // write edge to mstOutFile
+        mstOutFile << "(" << names.getName(edge.act1->getId()) << ")<--["
+                   << edge.movie->getMovieName() << "#@"
+                   << edge.movie->getMovieYear() << "]-->("
+                   << names.getName(edge.act2->getId()) << ")\n";
+    }
+
+    // Write total number of actors, edges, and total weight to mstOutfile.
+    mstOutFile << "#NODE CONNECTED: " << numActs << endl
+               << "#EDGE CHOSEN: " << mstEdges.size() << endl
+               << "TOTAL EDGE WEIGHTS: " << mstWeight << endl;
+}
+
+/** Write size of the compressed incidence lists, in total and per incidence */
+void ActorGraph::writeIncidenceStats(ostream& out)
+{
+    size_t numInc = actorMovies.size();
+    size_t bytes = actorMovies.memoryBytes() + movieCast.memoryBytes();
+
+    out << "#INCIDENCES: " << numInc << endl
+        << "ACTOR->MOVIE BYTES: " << actorMovies.memoryBytes() << endl
+        << "MOVIE->ACTOR BYTES: " << movieCast.memoryBytes() << endl
+        << "BYTES PER INCIDENCE: "
+        << (numInc ? (double)bytes / numInc : 0.0) << endl;
+}
+
+/** Write memory used by each structure of the graph after stage: live
+ *  bytes, peak bytes since the last resetMemoryPeaks, and live objects
+ */
+void ActorGraph::writeMemoryReport(const string& stage, ostream& out)
+{
+    long long actorBytes = 0; // actor nodes; their names are in the name index
+    long long movieBytes = 0; // movie nodes and their names
+    long long bytes = 0;
+    long long peak = 0;
+    long long objects = 0;
+
+    for(Actor* actor : actorById) actorBytes += actor->memoryBytes();
+    for(Movie* movie : movieById) movieBytes += movie->memoryBytes();
+
+    out << "Memory after " << stage << ":\n";
+    writeMemHeader(out);
+    writeMemLine(out, "actor nodes", actorBytes, actorBytes, actorById.size());
+    writeMemLine(out, "movie nodes", movieBytes, movieBytes, movieById.size());
+    writeMemCounters(out, bytes, peak, objects);
+    writeMemLine(out, "total (peaks summed)", bytes + actorBytes + movieBytes,
+                 peak + actorBytes + movieBytes,
+                 objects + actorById.size() + movieById.size());
+}
+
+/** Restart the peak bytes of every structure at its live bytes */
+void ActorGraph::resetMemoryPeaks()
+{
+    resetMemPeaks();
+}
+
+/** Write every actor name starting with prefix, one per line, in order */
+void ActorGraph::writeActorsWithPrefix(const string& prefix, ostream& out)
+{
+    vector<int> ids;
+
+    names.findPrefix(prefix, ids);
+
+    for(int id : ids)
+        out << names.getName(id) << "\n";
+}
+
+/** Write degree of separation histogram, eccentricity and closeness of
+ *  each source actor listed in sources, using numThreads threads.
+ */
+void ActorGraph::writeSeparationStats(istream& sources, ostream& out,
+                                      int numThreads)
+{
+    const int BATCH = 64; // sources per BFS batch, one per bit of a word
+    vector<string> sourceNames; // source actors (first column), in input order
+    vector<int> sourceIds;      // id of each source, or NameIndex::UNKNOWN
+    vector<int> ids;            // ids of the known source actors
+    string name;
+    string trash;
+
+    getline(sources, trash); // go past header
+
+    // read all source actors, then resolve their names in one batch
+    while(getline(sources, name))
+    {
+        name = name.substr(0, name.find('\t'));
+        if(!name.empty()) sourceNames.push_back(name);
+    }
+
+    names.findAll(sourceNames, sourceIds);
+
+    for(unsigned int i = 0; i < sourceIds.size(); ++i)
+    {
+        if(sourceIds[i] == NameIndex::UNKNOWN)
+            cerr << "Unknown actor: " << sourceNames[i] << endl;
+        else
+            ids.push_back(sourceIds[i]);
+    }
+
+    int numBatches = (ids.size() + BATCH - 1) / BATCH;
+    vector<dist_histogram> hist(ids.size()); // histogram of each source
+    atomic<int> nextBatch(0);                // next batch not yet taken
+    vector<thread> workers;
+
+    /** each worker takes batches of 64 sources until none are left, so
+     *  threads that get small components do not sit idle
+     */
+    for(int t = 0; t < max(1, min(numThreads, numBatches)); ++t)
+    {
+        workers.push_back(thread([&]()
+        {
+            BfsFrontiers bfs;
+            int batch;
+
+            while((batch = nextBatch++) < numBatches)
+            {
+                auto first = ids.begin() + batch * BATCH;
+                vector<int> batchIds(first, min(first + BATCH, ids.end()));
+
+                separationBatch(batchIds, bfs, &hist[batch * BATCH]);
+            }
+        }));
+    }
+
+    for(thread& worker : workers)
+        worker.join();
+
+    // write header of stats file
+    out << "actor\teccentricity\treached\tcloseness\thistogram" << endl;
+
+    // write stats of every source, in input order
+    for(unsigned int i = 0; i < ids.size(); ++i)
+    {
+        long long reached = 0;
+        long long distSum = 0;
+
+        for(unsigned int d = 0; d < hist[i].size(); ++d)
+        {
+            reached += hist[i][d];
+            distSum += d * hist[i][d];
+        }
+
+        out << names.getName(ids[i]) << "\t" << hist[i].size() - 1
+            << "\t" << reached << "\t"
+            << (distSum ? (double)(reached - 1) / distSum : 0.0) << "\t";
+
+        for(unsigned int d = 0; d < hist[i].size(); ++d)
+            out << (d ? "," : "") << hist[i][d];
+
+        out << "\n";
+    }
+}
+
+/** Run an unweighted BFS from every actor id in sources (at most 64) at
+ *  once. hist[i][d] is set to the number of actors at distance d from
+ *  sources[i].
+ */
+void ActorGraph::separationBatch(const vector<int>& sources, BfsFrontiers& bfs,
+                                 dist_histogram* hist)
+{
+    unsigned int level = 0; // distance of the actors in the frontier
+    int movieId;
+    int actorId;
+
+    // start from clean frontiers (scratch space is reused between batches)
+    bfs.seen.assign(actorById.size(), 0);
+    bfs.frontier.assign(actorById.size(), 0);
+    bfs.movieSeen.assign(movieById.size(), 0);
+    bfs.movieFront.assign(movieById.size(), 0);
+    bfs.currActs.clear();
+
+    // each source reaches itself at distance 0
+    for(unsigned int i = 0; i < sources.size(); ++i)
+    {
+        uint64_t bit = (uint64_t)1 << i;
+
+        if(!bfs.frontier[sources[i]]) bfs.currActs.push_back(sources[i]);
+        bfs.seen[sources[i]] |= bit;
+        bfs.frontier[sources[i]] |= bit;
+        hist[i] = dist_histogram(1, 1);
+    }
+
+    while(!bfs.currActs.empty())
+    {
+        ++level;
+
+        /** push frontier bits of each actor into their movies. A source that
+         *  already went through a movie has reached its whole cast
+         */
+        for(int act : bfs.currActs)
+        {
+            IncidenceList::Cursor movieItr =
+                    actorMovies.range(act, windowStart, windowEnd,
+                                      addedStart, addedEnd);
+
+            while(movieItr.next(movieId))
+            {
+                uint64_t bits = bfs.frontier[act] & ~bfs.movieSeen[movieId];
+                if(!bits) continue;
+
+                if(!bfs.movieFront[movieId]) bfs.currMovies.push_back(movieId);
+                bfs.movieFront[movieId] |= bits;
+                bfs.movieSeen[movieId] |= bits;
+            }
+
+            bfs.frontier[act] = 0;
+        }
+
+        // push movie bits into the cast members not reached by those sources
+        for(int movie : bfs.currMovies)
+        {
+            uint64_t bits = bfs.movieFront[movie];
+            IncidenceList::Cursor castItr = movieCast.list(movie);
+
+            while(castItr.next(actorId))
+            {
+                uint64_t newBits = bits & ~bfs.seen[actorId];
+                if(!newBits) continue;
+
+                if(!bfs.frontier[actorId]) bfs.nextActs.push_back(actorId);
+                bfs.frontier[actorId] |= newBits;
+                bfs.seen[actorId] |= newBits;
+            }
+
+            bfs.movieFront[movie] = 0;
+        }
+
+        bfs.currMovies.clear();
+
+        // count actors reached at this level, for each source
+        for(int act : bfs.nextActs)
+        {
+            for(uint64_t bits = bfs.frontier[act]; bits; bits &= bits - 1)
+            {
+                dist_histogram& sourceHist = hist[__builtin_ctzll(bits)];
+
+                if(sourceHist.size() <= level) sourceHist.resize(level + 1);
+                ++sourceHist[level];
+            }
+        }
+
+        swap(bfs.currActs, bfs.nextActs);
+        bfs.nextActs.clear();
+    }
 }
 
 /** Finds sentinel value of actor in the disjoint set (up-tree). Includes path compression logic. */
@@ -15,11 +15,20 @@
 #ifndef ACTORGRAPH_HPP
 #define ACTORGRAPH_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <stack>
 #include <unordered_map>
+#include <unordered_set>
 #include <queue>
+#include <set>
 #include "Actor.hpp"
+#include "CastReader.hpp"
+#include "IncidenceList.hpp"
+#include "LinkCutTree.hpp"
+#include "MemoryStats.hpp"
+#include "NameIndex.hpp"
+#include "SearchKernel.hpp"
 
 using namespace std;
 
@@ -41,12 +50,90 @@ public:
     bool operator() (Movie* mov1, Movie* mov2);
 };
 
-typedef unordered_map<string, Movie*> movie_archive;
-typedef unordered_map<string, Actor*> actor_collection;
-typedef pair<string, Actor*> actor; // <actor_name, Actor*>
-typedef unordered_map<string, Actor*> hash_table;
-typedef priority_queue<Actor*, vector<Actor*>, ActCompare> actor_pq;
-typedef priority_queue<Movie*, vector<Movie*>, MovCompare> movie_pq;
+/** string keyed map whose nodes, buckets and key text are charged to Tag */
+template <class T, int Tag>
+using counted_map = unordered_map<counted_string<Tag>, T, CountedStringHash,
+                                  equal_to<counted_string<Tag>>,
+                                  CountingAllocator<pair<const counted_string<Tag>, T>, Tag>>;
+
+typedef counted_map<Movie*, MEM_MOVIE_ARCHIVE> movie_archive;
+/** actors touched by a search, keyed by node so no name is copied */
+typedef unordered_set<Actor*, hash<Actor*>, equal_to<Actor*>,
+                      CountingAllocator<Actor*, MEM_PATH_SEARCH>> hash_table;
+typedef priority_queue<Actor*, counted_vector<Actor*, MEM_PATH_SEARCH>, ActCompare> actor_pq;
+typedef priority_queue<Movie*, counted_vector<Movie*, MEM_MOVIE_QUEUE>, MovCompare> movie_pq;
+typedef vector<long long> dist_histogram; // number of actors at each distance
+
+/** Partial path of a hop-bounded weighted search or of a spur search.
+ *  Reaches actor through movie, extending the label at index prev (-1 for
+ *  the origin).
+ */
+struct PathLabel {
+    Actor* actor;
+    Movie* movie;
+    int dist; // total strength (spur search: path weight) from origin
+    int hops; // number of movies from origin
+    int prev;
+};
+
+typedef pair<pair<int, int>, int> label_key; // <<dist, hops>, label index>
+typedef priority_queue<label_key, counted_vector<label_key, MEM_PATH_SEARCH>,
+                       greater<label_key>> label_pq;
+
+/** Simple path found by the k shortest paths search. movies[i] connects
+ *  actors[i] to actors[i + 1]. Ordered by dist, then by actors and movies
+ */
+struct ActorPath {
+    int dist;
+    vector<int> actors;
+    vector<int> movies;
+    int deviation; // index of the actor where it left the path it came from
+
+    bool operator<(const ActorPath& other) const
+    {
+        if(dist != other.dist) return dist < other.dist;
+        if(actors != other.actors) return actors < other.actors;
+        return movies < other.movies;
+    }
+};
+
+typedef pair<int, int> path_edge; // <movie id, next actor id>
+
+/** marks in ActorGraph::blockedActor while a spur path is searched */
+enum SpurBlock { ON_ROOT = 1, EDGE_TARGET = 2, ON_CHAIN = 4 };
+
+/** Pairs read by writeShortestPaths, with their names resolved to ids */
+struct PairBatch {
+    vector<string> origins;      // origin actor of each pair
+    vector<string> destinations; // destination actor of each pair
+    vector<int> origIds;         // id of each origin, or NameIndex::UNKNOWN
+    vector<int> destIds;         // id of each destination, or NameIndex::UNKNOWN
+};
+
+/** Edge of the minimum spanning forest: act1 and act2 star in movie */
+struct MSTEdge {
+    Actor* act1;
+    Actor* act2;
+    Movie* movie;
+};
+
+class ActorGraph;
+
+/** one instantiation of ActorGraph::searchKernel */
+typedef bool (ActorGraph::*search_kernel)(int orig, int dest, SearchState& state);
+
+/** Scratch space for one multi-source BFS batch. Bit i of every word
+ *  belongs to the i-th source of the batch.
+ */
+struct BfsFrontiers {
+    vector<uint64_t> seen;       // sources that have reached each actor
+    vector<uint64_t> frontier;   // sources that reached each actor last level
+    vector<uint64_t> movieSeen;  // sources that already went through each movie
+    vector<uint64_t> movieFront; // sources going through each movie this level
+    vector<int> currActs;        // actors with a non-empty frontier
+    vector<int> nextActs;        // actors reached in the level being expanded
+    vector<int> currMovies;      // movies with a non-empty movieFront
+};
 
 /**
  * Class to hold Actor nodes which are connected to other nodes by movies
@@ -55,32 +142,196 @@ typedef priority_queue<Movie*, vector<Movie*>, MovCompare> movie_pq;
  */
 class ActorGraph {
 protected:
-     actor_collection actors;  // collection of Actor* nodes (name, node)
+     NameIndex names;          // name of every actor, by actor id; loads intern new names
      hash_table processed;     // to hold processed Actors to reset for next iter
      movie_archive movieArchive; // collection of all movies amongst actors
      actor_pq pq;                // queue to use in dijkstras
-     stack<Actor*> path;         // to record shortest path from actor A to B
+     stack<Actor*, counted_deque<Actor*, MEM_PATH_SEARCH>> path; // to record shortest path from actor A to B
      movie_pq ordEdges;          // ordered edges (movies ordered by strength)
      int numActors;              // total number of nodes in graph
+     counted_vector<Actor*, MEM_NODE_TABLES> actorById; // actor nodes indexed by Actor::getId
+     counted_vector<Movie*, MEM_NODE_TABLES> movieById; // movies indexed by Movie::getId
+     IncidenceList actorMovies;  // compressed movies of each actor (by id)
+     IncidenceList movieCast;    // compressed cast of each movie (by id)
+     incidence_vector newIncidences; // <actor id, movie id> read but not compressed yet
+     int baseMovies;             // movies of the last full incidence build; ids [0, baseMovies) are in year order
+     int windowStart;            // first built movie id inside the year window
+     int windowEnd;              // one past the last built movie id inside the window
+     int addedStart;             // first added movie id inside the year window
+     int addedEnd;               // one past the last added movie id inside the window
+     bool weighted;              // true if movie strength depends on year
+     int maxHops;                // longest path searched, in movies (-1: no bound)
+     int maxStrength;            // longest path searched, in strength (-1: no bound)
+     counted_vector<PathLabel, MEM_PATH_SEARCH> labels; // partial paths of hop-bounded or spur search
+     label_pq labelPq;           // label indices by (dist, hops) for those searches
+     search_kernel kernel;       // selected search, nullptr for getShortestPath
+     WeightPolicy kernelWeights; // weight policy of the selected search
+     FrontierPolicy kernelFrontier; // frontier of the selected search
+     int bucketSpan;             // largest movie weight + 1, for bucket frontier
+     SearchState searchState;    // per-query arrays of the selected search
+     int minWindowYear;          // first year of the year window
+     int maxWindowYear;          // last year of the year window
+     vector<Movie*> loadedMovies; // movies given new cast by the current load
+     vector<char> movieLoaded;   // 1 for each earlier movie in loadedMovies
+     bool hasMST;                // true once buildMST ran; loads then update it
+     LinkCutTree mstForest;      // actors and MST edges as a dynamic forest
+     counted_vector<int, MEM_MST> actorNode;   // forest node of each actor, by actor id
+     counted_vector<MSTEdge, MEM_MST> mstEdges; // edge held by each edge node, by node tag
+     long long mstWeight;        // total strength of the MST edges
+     int numWorkers;             // processes answering path queries (1: this one)
+     int workerTimeout;          // seconds a worker may spend on a chunk of pairs (0: no limit)
+     int numPaths;               // paths written per pair (1: shortest only)
+     SearchState destTree;       // shortest paths to the current k-path destination
+     counted_vector<char, MEM_SEARCH_STATE> blockedActor; // on the root of a spur path
+     counted_vector<char, MEM_SEARCH_STATE> movieExpanded; // movie's cast reached by destTree
+     counted_vector<int, MEM_SEARCH_STATE> pathWeight; // weight of each movie in k-path searches
+     bool unitPaths;             // every pathWeight is 1, so hops are the path weight
+     counted_vector<int, MEM_SEARCH_STATE> treeHops; // movies on each actor's destTree path
+     counted_vector<int, MEM_SEARCH_STATE> destHops; // fewest movies from each actor to dest (-1: none)
+     counted_vector<int, MEM_SEARCH_STATE> spurHops; // fewest hops each actor was expanded with by the spur search
+
+    /** Undo a failed loadFromFile: delete the actors and movies it interned
+     *  past the first oldActors and oldMovies, and the incidences it read,
+     *  so the graph is left as the previous load built it
+     */
+    void rollbackLoad(int oldActors, int oldMovies);
+
+    /** Interner stage of loadFromFile: turn each record's names into an Actor
+     *  and a Movie, creating them when first seen, and pass the <actor id,
+     *  movie id> pairs on to the incidence builder
+     */
+    void internRecords(SpscQueue<RecordBatch*>& records,
+                       SpscQueue<incidence_vector*>& incidences, bool useWeight);
+
+    /** Incidence builder stage of loadFromFile: collect the <actor id, movie id>
+     *  pairs until they are compressed
+     */
+    void appendIncidences(SpscQueue<incidence_vector*>& incidences);
+
+    /** Compress the incidences read by loadFromFile into actorMovies and movieCast.
+     *  Movies are renumbered in order of release year first. Small loads go
+     *  to the added lists through addIncidence instead
+     */
+    void buildIncidence();
+
+    /** Add the incidences read by loadFromFile to the added lists of
+     *  actorMovies and movieCast, leaving the built lists as they are.
+     *  Movies past baseMovies are renumbered in order of release year
+     */
+    void addIncidence();
+
+    /** Add an edge between act1 and act2 through movie to the MST, which
+     *  must not connect them yet
+     */
+    void linkMSTEdge(Actor* act1, Actor* act2, Movie* movie);
+
+    /** Offer an edge between act1 and act2 through movie to the MST. It is
+     *  added if it joins two trees, or replaces the heaviest edge of the
+     *  cycle it closes if that edge is heavier
+     */
+    void insertMSTEdge(Actor* act1, Actor* act2, Movie* movie);
 
-    /** Update the actor anc movie archive as necessary */
-    void updateGraph(Actor* actor, Movie* movie);
+    /** Offer the cast of every movie of the current load to the MST */
+    void updateMST();
+
+    /** check if movie is inside the current year window */
+    bool inWindow(Movie* movie);
 
     /** set origin and destination for actors */
     void getOriginAndDest(string& origin, string& dest, istream& currLine);
 
-    /** find shortest path from actor A to B. Writes a formatted path to a file */
-    void getShortestPath(string& origin, string& destination, ostream& pathsFile);
+    /** find shortest path from actor A to B within the search bounds.
+     *  Writes a formatted path to a file. Returns false if there is none
+     */
+    bool getShortestPath(Actor* origin, Actor* destination, ostream& pathsFile);
+
+    /** find the lowest weight path from actor A to B using at most maxHops
+     *  movies, each weighing Weight::weight. Writes a formatted path to a
+     *  file. Returns false if there is none
+     */
+    template <class Weight>
+    bool getHopBoundedPath(Actor* origin, Actor* destination, ostream& pathsFile);
+
+    /** find and write the path of pairs [begin, end) of batch. Unknown
+     *  actors and paths out of bounds are reported to err
+     */
+    void writePairPaths(const PairBatch& batch, int begin, int end,
+                        ostream& pathsFile, ostream& err);
+
+    /** weight of movie under the selected search: its weight policy if a
+     *  kernel is selected, else its strength
+     */
+    int movieWeight(Movie* movie);
+
+    /** Fill destTree with the shortest path from every actor to dest, by
+     *  pathWeight. prevActor of an actor is the next actor on its way to
+     *  dest. Also fills treeHops, and destHops if hops are bounded
+     */
+    void buildDestTree(int dest);
+
+    /** find the shortest path from spur to the destination of destTree
+     *  that avoids blocked actors, leaves spur through none of blockedEdges
+     *  and has at most hopBudget movies and weightBudget weight (-1: no
+     *  bound). An A* search on labels guided by the tree distances, which
+     *  stops at the first label whose tree path is allowed. false if there
+     *  is none
+     */
+    bool findSpurPath(int spur, const vector<path_edge>& blockedEdges,
+                      int hopBudget, int weightBudget, ActorPath& path);
+
+    /** check if the tree path from the actor of label, reached by the spur
+     *  search, avoids blocked actors and edges and the searched path to it,
+     *  and keeps the whole path within hopBudget movies (-1: no bound)
+     */
+    bool treePathAllowed(int label, const vector<path_edge>& blockedEdges,
+                         int hopBudget);
+
+    /** find and write up to numPaths shortest simple paths from actor A
+     *  to B in order of length (Yen's algorithm). Returns false if there
+     *  is none within the search bounds
+     */
+    bool writeTopPaths(Actor* origin, Actor* destination, ostream& pathsFile);
+
+    /** Write a path found by writeTopPaths in the format of writePathToDest */
+    void writeActorPath(const ActorPath& path, ostream& out);
 
     /** Write a formatted path to a file from shortest path func */
     void writePathToDest(ostream & out);
 
+    /** Shortest path search specialized on a weight and frontier policy.
+     *  Leaves the path to dest in state. Returns false if there is none
+     */
+    template <class Weight, class Frontier>
+    bool searchKernel(int orig, int dest, SearchState& state);
+
+    /** get the searchKernel instantiation for Weight and frontier, or
+     *  nullptr if that frontier cannot order Weight's distances
+     */
+    template <class Weight>
+    search_kernel kernelFor(FrontierPolicy frontier);
+
+    /** Write the path to dest left in state by searchKernel */
+    void writeStatePath(SearchState& state, int dest, ostream& out);
+
+    /** find path from actor A to B with the selected search, within the
+     *  search bounds. Writes a formatted path to a file. Returns false if
+     *  there is none
+     */
+    bool findPath(Actor* origin, Actor* destination, ostream& pathsFile);
+
     /** Finds sentinel value of actor in the disjoint set (up-tree). Includes path compression logic. */
     Actor* setFind(Actor* actor);
 
     /** Unions two disjoint sets to form a new disjoint set (up-tree) of actors. */
     void setUnion(Actor* act1, Actor* act2);
 
+    /** Run an unweighted BFS from every actor id in sources (at most 64) at
+     *  once. hist[i][d] is set to the number of actors at distance d from
+     *  sources[i].
+     */
+    void separationBatch(const vector<int>& sources, BfsFrontiers& bfs,
+                         dist_histogram* hist);
+
 public:
     ActorGraph();
     ~ActorGraph();
@@ -91,7 +342,7 @@ public:
      *
      * Load the graph from a tab-delimited file of actor->movie relationships.
      *
-     * in_filename - input filename
+     * in_filename - input filename, plain or gzip compressed
      * use_weighted_edges - if true, compute edge weights as 1 + (2019 - movie_year), 
      *                      otherwise all edge weights will be 1
      *
@@ -99,15 +350,69 @@ public:
      */
     bool loadFromFile(char* in_filename, bool useWeight, bool isTrav);
 
+    /** Only use movies released from minYear to maxYear (inclusive) in
+     *  following shortest path and MST queries. Call after loadFromFile.
+     */
+    void setYearWindow(int minYear, int maxYear);
+
+    /** Only accept paths of at most hops movies and total strength of at
+     *  most strength in following shortest path queries. -1 for no bound
+     */
+    void setSearchBounds(int hops, int strength);
+
+    /** Use the search specialized on weights and frontier in following
+     *  shortest path queries. Returns false, keeping the current search,
+     *  if the frontier cannot order those weights. Each later load selects
+     *  it again, so the bucket span covers the new movies
+     */
+    bool selectKernel(WeightPolicy weights, FrontierPolicy frontier);
+
+    /** Answer following shortest path queries on num worker processes
+     *  forked from this one. 1 answers them in this process. A worker that
+     *  spends over timeout seconds on one chunk of pairs is restarted
+     *  (0: no limit)
+     */
+    void setWorkers(int num, int timeout);
+
+    /** Write the num shortest simple paths of each pair in following
+     *  queries, shortest first. 1 writes only the shortest path
+     */
+    void setPathCount(int num);
+
     /** write shortest path for each pair of actors
-     *  in pairs file -- initial call.
+     *  in pairs file -- initial call. Returns false if the worker processes
+     *  gave up on some pairs
      **/
-    void writeShortestPaths(istream& allPairs, ostream& pathsFile);
+    bool writeShortestPaths(istream& allPairs, ostream& pathsFile);
+
+    /** Build the Minimum Spanning Tree with Kruskal's algorithm. Movies
+     *  added by later loads update it instead of rebuilding it
+     */
+    void buildMST();
 
     /** Write a Minimum Spanning Tree to mstOutFile, including header, shortest weighted paths, num of actors and movies
      *  and total edge weight.
      */
     void writeMST(ostream& mstOutFile);
+
+    /** Write size of the compressed incidence lists, in total and per incidence */
+    void writeIncidenceStats(ostream& out);
+
+    /** Write memory used by each structure of the graph after stage: live
+     *  bytes, peak bytes since the last resetMemoryPeaks, and live objects
+     */
+    void writeMemoryReport(const string& stage, ostream& out);
+
+    /** Restart the peak bytes of every structure at its live bytes */
+    void resetMemoryPeaks();
+
+    /** Write every actor name starting with prefix, one per line, in order */
+    void writeActorsWithPrefix(const string& prefix, ostream& out);
+
+    /** Write degree of separation histogram, eccentricity and closeness of
+     *  each source actor listed in sources, using numThreads threads.
+     */
+    void writeSeparationStats(istream& sources, ostream& out, int numThreads);
   
 };
 
@@ -0,0 +1,147 @@
+/**
+ * Filename:     CastReader.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com, zlib.net/manual.html
+ *
+ * Description:  First two stages of the ActorGraph load pipeline. The reader
+ *               stage reads the cast file (plain or gzip compressed) in large
+ *               blocks of whole lines. The tokenizer stage splits each block
+ *               into actor, movie and year records pointing into the block.
+ */
+
+#include <algorithm>
+#include <zlib.h>
+#include "CastReader.hpp"
+
+static const int BLOCK_SIZE = 1 << 20; // bytes read per block
+static const int MAX_YEAR_DIGITS = 5;  // longer years are malformed lines
+
+/** Reader stage: push blocks of whole lines, then nullptr */
+void CastReader::readBlocks(SpscQueue<CastBlock*>& blocks)
+{
+    // gzread passes plain files through unchanged, so both go this way
+    gzFile file = gzopen(filename.c_str(), "rb");
+    vector<char> carry; // partial last line of the previous block
+    int numRead = 0;
+
+    if(!file)
+    {
+        failed = true;
+        blocks.push(nullptr);
+        return;
+    }
+
+    gzbuffer(file, 1 << 17);
+
+    do
+    {
+        CastBlock* block = new CastBlock();
+
+        // start with the line cut off at the end of the last block
+        block->text.swap(carry);
+        size_t start = block->text.size();
+        block->text.resize(start + BLOCK_SIZE);
+
+        numRead = gzread(file, block->text.data() + start, BLOCK_SIZE);
+        if(numRead < 0)
+        {
+            failed = true;
+            numRead = 0;
+        }
+
+        block->text.resize(start + numRead);
+
+        // keep only whole lines; the rest goes to the next block
+        if(numRead > 0)
+        {
+            auto lastLine = find(block->text.rbegin(), block->text.rend(), '\n');
+            carry.assign(lastLine.base(), block->text.end());
+            block->text.erase(lastLine.base(), block->text.end());
+        }
+
+        // file does not end with a newline; last line still counts
+        else if(!block->text.empty())
+            block->text.push_back('\n');
+
+        if(block->text.empty()) delete block;
+        else blocks.push(block);
+    }
+    while(numRead > 0);
+
+    // gzread ends a cut off gzip file quietly; only gzclose reports it
+    if(gzclose(file) != Z_OK) failed = true;
+    blocks.push(nullptr);
+}
+
+/** Tokenizer stage: push one batch of records per block, then nullptr.
+ *  Skips the header line, lines without exactly 3 columns and lines
+ *  whose year is not a number of at most MAX_YEAR_DIGITS digits
+ */
+void CastReader::tokenize(SpscQueue<CastBlock*>& blocks,
+                          SpscQueue<RecordBatch*>& batches)
+{
+    bool have_header = false;
+    CastBlock* block;
+
+    while((block = blocks.pop()) != nullptr)
+    {
+        RecordBatch* batch = new RecordBatch();
+        const char* pos = block->text.data();
+        const char* end = pos + block->text.size();
+
+        batch->block = block;
+
+        // blocks hold whole lines only, each ending in a newline
+        while(pos < end)
+        {
+            const char* lineEnd = find(pos, end, '\n');
+            const char* cols[3]; // start of each column
+            int numCols = 1;
+
+            cols[0] = pos;
+            for(const char* c = pos; c < lineEnd && numCols <= 3; ++c)
+                if(*c == '\t' && numCols++ < 3) cols[numCols - 1] = c + 1;
+
+            const char* line = pos;
+            pos = lineEnd + 1;
+
+            if(!have_header)
+            {
+                // skip the header
+                have_header = true;
+                continue;
+            }
+
+            // we should have exactly 3 columns
+            if(numCols != 3 || line == lineEnd) continue;
+
+            // year column is a number, with an optional sign
+            const char* digit = cols[2];
+            bool negative = digit < lineEnd && *digit == '-';
+            int year = 0;
+
+            if(digit < lineEnd && (*digit == '-' || *digit == '+')) ++digit;
+            if(digit == lineEnd || *digit < '0' || *digit > '9') continue;
+
+            const char* yearStart = digit;
+            for(; digit < lineEnd && *digit >= '0' && *digit <= '9'; ++digit)
+                if(digit - yearStart < MAX_YEAR_DIGITS)
+                    year = year * 10 + (*digit - '0');
+
+            // a longer year would overflow; the line is malformed
+            if(digit - yearStart > MAX_YEAR_DIGITS) continue;
+
+            batch->records.push_back(CastRecord{
+                cols[0], (int)(cols[1] - 1 - cols[0]),
+                cols[1], (int)(cols[2] - 1 - cols[1]),
+                negative ? -year : year});
+        }
+
+        batches.push(batch);
+    }
+
+    batches.push(nullptr);
+}
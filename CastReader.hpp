@@ -0,0 +1,69 @@
+/**
+ * Filename:     CastReader.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com, zlib.net/manual.html
+ *
+ * Description:  First two stages of the ActorGraph load pipeline. The reader
+ *               stage reads the cast file (plain or gzip compressed) in large
+ *               blocks of whole lines. The tokenizer stage splits each block
+ *               into actor, movie and year records pointing into the block.
+ */
+
+#ifndef PA4_CASTREADER_HPP
+#define PA4_CASTREADER_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "SpscQueue.hpp"
+
+using namespace std;
+
+/** Whole lines of the cast file, in file order */
+struct CastBlock {
+    vector<char> text;
+};
+
+/** One actor, movie, year line. Names point into the block they came from */
+struct CastRecord {
+    const char* actor;
+    int actorLen;
+    const char* movie;
+    int movieLen;
+    int year;
+};
+
+/** Records of one block. Whoever consumes the batch deletes the block */
+struct RecordBatch {
+    CastBlock* block;
+    vector<CastRecord> records;
+};
+
+/** Reads and tokenizes one tab-delimited cast file. Each stage runs on its
+ *  own thread; a nullptr pushed to a queue marks the end of the file
+ */
+class CastReader {
+private:
+    string filename;
+    atomic<bool> failed; // true if the file could not be read to the end
+
+public:
+    CastReader(const char* filename) : filename(filename), failed(false) {}
+
+    /** Reader stage: push blocks of whole lines, then nullptr */
+    void readBlocks(SpscQueue<CastBlock*>& blocks);
+
+    /** Tokenizer stage: push one batch of records per block, then nullptr.
+     *  Skips the header line, lines without exactly 3 columns and lines
+     *  whose year is not a number of at most 5 digits
+     */
+    void tokenize(SpscQueue<CastBlock*>& blocks, SpscQueue<RecordBatch*>& batches);
+
+    /** check if the file could not be read to the end */
+    bool hasFailed() const {return failed;}
+};
+
+#endif //PA4_CASTREADER_HPP
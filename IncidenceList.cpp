@@ -0,0 +1,172 @@
+/**
+ * Filename:     IncidenceList.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Compressed adjacency storage for the ActorGraph. Holds one
+ *               sorted list of integer ids per node (movies of an actor, or
+ *               cast of a movie). Each list is delta encoded and every delta
+ *               is written as a varint, so most incidences cost 1-2 bytes
+ *               instead of a hash map node. Incidences of later loads go to
+ *               small added lists until the next full build.
+ */
+
+#include <algorithm>
+#include "IncidenceList.hpp"
+
+/** Encode numLists lists from (list, member) pairs, dropping any added
+ *  lists. pairs is sorted and deduplicated in place; duplicate
+ *  incidences are stored only once.
+ */
+void IncidenceList::build(int numLists, incidence_vector& pairs)
+{
+    // group members by list, each list in increasing order, then drop repeats
+    sort(pairs.begin(), pairs.end());
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+    bytes = byte_vector();
+    offsets = offset_vector();
+    skips = counted_vector<SkipPoint, MEM_INCIDENCE_LISTS>();
+    skipStarts = offset_vector();
+    numIncidences = pairs.size();
+
+    encode(numLists, pairs, bytes, offsets, &skips, &skipStarts);
+
+    // everything is in the built lists now
+    addedBytes = byte_vector();
+    addedOffsets = offset_vector();
+    numAdded = 0;
+}
+
+/** Replace the added lists with numLists lists from (list, member)
+ *  pairs. pairs is sorted and deduplicated in place, and must not
+ *  repeat a built incidence
+ */
+void IncidenceList::buildAdded(int numLists, incidence_vector& pairs)
+{
+    sort(pairs.begin(), pairs.end());
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+    addedBytes = byte_vector();
+    addedOffsets = offset_vector();
+    numAdded = pairs.size();
+
+    // added lists are short, so they go without skip points
+    encode(numLists, pairs, addedBytes, addedOffsets, nullptr, nullptr);
+}
+
+/** append every (list, member) pair of the added lists to pairs */
+void IncidenceList::addedPairs(incidence_vector& pairs) const
+{
+    int id;
+
+    pairs.reserve(pairs.size() + numAdded);
+
+    for(unsigned int list = 0; list + 1 < addedOffsets.size(); ++list)
+    {
+        Cursor itr(nullptr, nullptr);
+        itr.setAdded(addedBytes.data() + addedOffsets[list],
+                     addedBytes.data() + addedOffsets[list + 1],
+                     0, INT_MAX, 0, 0);
+
+        while(itr.next(id))
+            pairs.push_back(incidence(list, id));
+    }
+}
+
+/** encode numLists lists from sorted, deduplicated pairs into out and
+ *  listStarts, with skip points into skipOut if it is not nullptr
+ */
+void IncidenceList::encode(int numLists, const incidence_vector& pairs,
+                           byte_vector& out, offset_vector& listStarts,
+                           counted_vector<SkipPoint, MEM_INCIDENCE_LISTS>* skipOut,
+                           offset_vector* skipOutStarts)
+{
+    listStarts.reserve(numLists + 1);
+    if(skipOutStarts) skipOutStarts->reserve(numLists + 1);
+
+    auto itr = pairs.begin();
+
+    for(int currList = 0; currList < numLists; ++currList)
+    {
+        int last = 0;  // first id is stored as a delta from 0
+        int count = 0; // ids written to this list so far
+        listStarts.push_back(out.size());
+        if(skipOutStarts) skipOutStarts->push_back(skipOut->size());
+
+        // write deltas between consecutive members of this list
+        for(; itr != pairs.end() && itr->first == currList; ++itr)
+        {
+            writeVarint(out, itr->second - last);
+            last = itr->second;
+
+            // let range() resume decoding here instead of at the list head
+            if(skipOut && ++count % SKIP_EVERY == 0)
+                skipOut->push_back(SkipPoint{last, (uint32_t)out.size()});
+        }
+    }
+
+    // sentinels so the last list has an end offset
+    listStarts.push_back(out.size());
+    out.shrink_to_fit();
+
+    if(skipOut)
+    {
+        skipOutStarts->push_back(skipOut->size());
+        skipOut->shrink_to_fit();
+    }
+}
+
+/** get a decoder for the ids of list in [lo, hi) or [addedLo, addedHi)
+ *  only. Built ids start from the last skip point below lo, so at most
+ *  SKIP_EVERY ids are skipped
+ */
+IncidenceList::Cursor IncidenceList::range(int list, int lo, int hi,
+                                           int addedLo, int addedHi) const
+{
+    Cursor itr(nullptr, nullptr);
+
+    if(list + 1 < (int)offsets.size())
+    {
+        auto first = skips.begin() + skipStarts[list];
+        auto last = skips.begin() + skipStarts[list + 1];
+
+        // skip points whose last id is below lo can be resumed from safely
+        auto point = lower_bound(first, last, lo, [](const SkipPoint& skip, int id)
+                                 { return skip.last < id; });
+
+        const unsigned char* start = bytes.data() + offsets[list];
+        int before = 0;
+
+        if(point != first)
+        {
+            --point;
+            start = bytes.data() + point->pos;
+            before = point->last;
+        }
+
+        itr = Cursor(start, bytes.data() + offsets[list + 1], hi, before);
+        itr.skipTo(lo);
+    }
+
+    if(list + 1 < (int)addedOffsets.size())
+        itr.setAdded(addedBytes.data() + addedOffsets[list],
+                     addedBytes.data() + addedOffsets[list + 1],
+                     lo, hi, addedLo, addedHi);
+    return itr;
+}
+
+/** append val to out as a varint (7 bits per byte, high bit = more) */
+void IncidenceList::writeVarint(byte_vector& out, uint32_t val)
+{
+    while(val >= 0x80)
+    {
+        out.push_back((unsigned char)(val | 0x80));
+        val >>= 7;
+    }
+
+    out.push_back((unsigned char)val);
+}
@@ -0,0 +1,252 @@
+/**
+ * Filename:     IncidenceList.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Compressed adjacency storage for the ActorGraph. Holds one
+ *               sorted list of integer ids per node (movies of an actor, or
+ *               cast of a movie). Each list is delta encoded and every delta
+ *               is written as a varint, so most incidences cost 1-2 bytes
+ *               instead of a hash map node. Incidences of later loads go to
+ *               small added lists until the next full build.
+ */
+
+#ifndef PA4_INCIDENCELIST_HPP
+#define PA4_INCIDENCELIST_HPP
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "MemoryStats.hpp"
+
+using namespace std;
+
+typedef pair<int, int> incidence; // <list id, member id>
+typedef counted_vector<incidence, MEM_RAW_INCIDENCES> incidence_vector;
+
+/** Read-only collection of delta/varint encoded id lists, one per node.
+ *  Incidences added after the last build() go to a second, smaller set of
+ *  added lists; a cursor yields a list's built ids, then its added ids.
+ */
+class IncidenceList {
+private:
+    static const int SKIP_EVERY = 32; // ids decoded between two skip points
+
+    /** resume point after the (k * SKIP_EVERY)-th id of a list */
+    struct SkipPoint {
+        int last;      // id decoded just before this point
+        uint32_t pos;  // offset in bytes of the next id
+    };
+
+    typedef counted_vector<unsigned char, MEM_INCIDENCE_LISTS> byte_vector;
+    typedef counted_vector<uint32_t, MEM_INCIDENCE_LISTS> offset_vector;
+
+    byte_vector bytes;           // encoded deltas of every list, back to back
+    offset_vector offsets;       // list i lives in [offsets[i], offsets[i + 1])
+    counted_vector<SkipPoint, MEM_INCIDENCE_LISTS> skips; // skip points of every list, back to back
+    offset_vector skipStarts;    // list i's skip points are [skipStarts[i], skipStarts[i + 1])
+    size_t numIncidences;        // total number of ids over all built lists
+    byte_vector addedBytes;      // encoded deltas of every added list
+    offset_vector addedOffsets;  // added list i lives in [addedOffsets[i], addedOffsets[i + 1])
+    size_t numAdded;             // total number of ids over all added lists
+
+    /** append val to out as a varint (7 bits per byte, high bit = more) */
+    static void writeVarint(byte_vector& out, uint32_t val);
+
+    /** encode numLists lists from sorted, deduplicated pairs into out and
+     *  listStarts, with skip points into skipOut if it is not nullptr
+     */
+    static void encode(int numLists, const incidence_vector& pairs,
+                       byte_vector& out, offset_vector& listStarts,
+                       counted_vector<SkipPoint, MEM_INCIDENCE_LISTS>* skipOut,
+                       offset_vector* skipOutStarts);
+
+public:
+
+    /** Sequential decoder over a single list. Yields the list's built ids in
+     *  increasing order, then its added ids in increasing order
+     */
+    class Cursor {
+    private:
+        const unsigned char* pos; // next byte to decode
+        const unsigned char* end; // one past the last byte of the list
+        int last;                 // last decoded id (deltas are relative to it)
+        int limit;                // ids at or past limit end the list early
+        const unsigned char* addedPos; // next byte of the added ids
+        const unsigned char* addedEnd; // one past the last added byte
+        int addedLast;            // last decoded added id
+        int lo, hi;               // added ids in [lo, hi) are yielded,
+        int addedLo, addedHi;     // as are added ids in [addedLo, addedHi)
+
+        /** decode the next added id in range into id. false once done */
+        bool nextAdded(int& id)
+        {
+            while(addedPos != addedEnd)
+            {
+                uint32_t val = *addedPos & 0x7F;
+                int shift = 7;
+
+                while(*addedPos++ & 0x80)
+                {
+                    val |= (uint32_t)(*addedPos & 0x7F) << shift;
+                    shift += 7;
+                }
+
+                addedLast += val;
+
+                // added lists are short, so check every id against the window
+                if((addedLast >= lo && addedLast < hi)
+                   || (addedLast >= addedLo && addedLast < addedHi))
+                {
+                    id = addedLast;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    public:
+        Cursor(const unsigned char* pos, const unsigned char* end,
+               int limit = INT_MAX, int last = 0)
+            : pos(pos), end(end), last(last), limit(limit),
+              addedPos(nullptr), addedEnd(nullptr), addedLast(0),
+              lo(0), hi(INT_MAX), addedLo(0), addedHi(0) {}
+
+        /** follow the built ids with the added ids in [pos, end) that are
+         *  in [lo, hi) or [addedLo, addedHi)
+         */
+        void setAdded(const unsigned char* pos, const unsigned char* end,
+                      int lo, int hi, int addedLo, int addedHi)
+        {
+            addedPos = pos;
+            addedEnd = end;
+            this->lo = lo;
+            this->hi = hi;
+            this->addedLo = addedLo;
+            this->addedHi = addedHi;
+        }
+
+        /** decode the next id into id. Returns false once the list is done */
+        bool next(int& id)
+        {
+            if(pos == end) return nextAdded(id);
+
+            // first byte covers the common case of a delta below 128
+            uint32_t val = *pos & 0x7F;
+            int shift = 7;
+
+            while(*pos++ & 0x80)
+            {
+                val |= (uint32_t)(*pos & 0x7F) << shift;
+                shift += 7;
+            }
+
+            last += val;
+
+            // ids are sorted, so nothing past limit can be in range either
+            if(last >= limit)
+            {
+                pos = end;
+                return nextAdded(id);
+            }
+
+            id = last;
+            return true;
+        }
+
+        /** skip built ids below lo, so the next id decoded is at least lo.
+         *  Call before setAdded
+         */
+        void skipTo(int lo)
+        {
+            const unsigned char* start; // position of the id being checked
+            int before;                 // last id before the one being checked
+            int id;
+
+            while(true)
+            {
+                start = pos;
+                before = last;
+
+                if(!next(id)) return;
+
+                // first id in range; back up so next() yields it again
+                if(id >= lo)
+                {
+                    pos = start;
+                    last = before;
+                    return;
+                }
+            }
+        }
+    };
+
+    IncidenceList() : numIncidences(0), numAdded(0) {}
+
+    /** Encode numLists lists from (list, member) pairs, dropping any added
+     *  lists. pairs is sorted and deduplicated in place; duplicate
+     *  incidences are stored only once.
+     */
+    void build(int numLists, incidence_vector& pairs);
+
+    /** Replace the added lists with numLists lists from (list, member)
+     *  pairs. pairs is sorted and deduplicated in place, and must not
+     *  repeat a built incidence
+     */
+    void buildAdded(int numLists, incidence_vector& pairs);
+
+    /** append every (list, member) pair of the added lists to pairs */
+    void addedPairs(incidence_vector& pairs) const;
+
+    /** get a decoder for the ids in list */
+    Cursor list(int list) const
+    {
+        Cursor itr = list + 1 < (int)offsets.size()
+                     ? Cursor(bytes.data() + offsets[list],
+                              bytes.data() + offsets[list + 1])
+                     : Cursor(nullptr, nullptr);
+
+        if(list + 1 < (int)addedOffsets.size())
+            itr.setAdded(addedBytes.data() + addedOffsets[list],
+                         addedBytes.data() + addedOffsets[list + 1],
+                         0, INT_MAX, 0, 0);
+        return itr;
+    }
+
+    /** get a decoder for the ids of list in [lo, hi) or [addedLo, addedHi)
+     *  only. Built ids start from the last skip point below lo, so at most
+     *  SKIP_EVERY ids are skipped
+     */
+    Cursor range(int list, int lo, int hi, int addedLo = 0, int addedHi = 0) const;
+
+    /** number of lists held */
+    int numLists() const
+    {
+        // each set of offsets ends with a sentinel
+        size_t ends = max(offsets.size(), addedOffsets.size());
+        return ends ? ends - 1 : 0;
+    }
+
+    /** total number of ids held over all lists */
+    size_t size() const {return numIncidences + numAdded;}
+
+    /** number of ids held in the added lists */
+    size_t addedSize() const {return numAdded;}
+
+    /** bytes used by the encoded lists, their offsets and skip points */
+    size_t memoryBytes() const
+    {
+        return bytes.capacity() + offsets.capacity() * sizeof(uint32_t)
+               + skips.capacity() * sizeof(SkipPoint)
+               + skipStarts.capacity() * sizeof(uint32_t)
+               + addedBytes.capacity() + addedOffsets.capacity() * sizeof(uint32_t);
+    }
+};
+
+#endif //PA4_INCIDENCELIST_HPP
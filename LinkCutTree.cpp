@@ -0,0 +1,203 @@
+/**
+ * Filename:     LinkCutTree.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com, Sleator & Tarjan "A Data Structure for
+ *               Dynamic Trees"
+ *
+ * Description:  Link-cut tree (forest of splay trees over preferred paths)
+ *               holding the ActorGraph's minimum spanning forest. Every node
+ *               has a value; the forest can link and cut nodes and find the
+ *               node of largest value on the path between two nodes, each in
+ *               amortized O(log n). Edges are nodes too, so the largest edge
+ *               on a tree path can be found and replaced.
+ */
+
+#include <algorithm>
+#include "LinkCutTree.hpp"
+
+/** add a node with value val and tag, not linked to anything */
+int LinkCutTree::addNode(int val, int tag)
+{
+    left.push_back(-1);
+    right.push_back(-1);
+    parent.push_back(-1);
+    flipped.push_back(0);
+    value.push_back(val);
+    maxNode.push_back(value.size() - 1);
+    tags.push_back(tag);
+
+    return value.size() - 1;
+}
+
+/** check if x is the root of its splay tree */
+bool LinkCutTree::isSplayRoot(int x) const
+{
+    int p = parent[x];
+
+    // a path-parent does not have x as a child
+    return p < 0 || (left[p] != x && right[p] != x);
+}
+
+/** recompute maxNode of x from its children */
+void LinkCutTree::update(int x)
+{
+    maxNode[x] = x;
+
+    if(left[x] >= 0 && value[maxNode[left[x]]] > value[maxNode[x]])
+        maxNode[x] = maxNode[left[x]];
+    if(right[x] >= 0 && value[maxNode[right[x]]] > value[maxNode[x]])
+        maxNode[x] = maxNode[right[x]];
+}
+
+/** pass a pending flip of x down to its children */
+void LinkCutTree::pushDown(int x)
+{
+    if(!flipped[x]) return;
+
+    swap(left[x], right[x]);
+    if(left[x] >= 0) flipped[left[x]] ^= 1;
+    if(right[x] >= 0) flipped[right[x]] ^= 1;
+    flipped[x] = 0;
+}
+
+/** rotate x above its splay parent */
+void LinkCutTree::rotate(int x)
+{
+    int p = parent[x];
+    int g = parent[p];
+
+    // x takes p's place under g (or as path-parent holder)
+    if(!isSplayRoot(p))
+    {
+        if(left[g] == p) left[g] = x;
+        else right[g] = x;
+    }
+
+    parent[x] = g;
+
+    // x's inner child moves to p
+    if(left[p] == x)
+    {
+        left[p] = right[x];
+        if(right[x] >= 0) parent[right[x]] = p;
+        right[x] = p;
+    }
+    else
+    {
+        right[p] = left[x];
+        if(left[x] >= 0) parent[left[x]] = p;
+        left[x] = p;
+    }
+
+    parent[p] = x;
+    update(p);
+    update(x);
+}
+
+/** bring x to the root of its splay tree */
+void LinkCutTree::splay(int x)
+{
+    // push flips from the splay root down to x first. above keeps its
+    // capacity between calls, so splaying does not allocate
+    above.clear();
+    for(int y = x; ; y = parent[y])
+    {
+        above.push_back(y);
+        if(isSplayRoot(y)) break;
+    }
+
+    for(int i = above.size() - 1; i >= 0; --i)
+        pushDown(above[i]);
+
+    while(!isSplayRoot(x))
+    {
+        int p = parent[x];
+
+        // zig-zig rotates parent first, zig-zag rotates x twice
+        if(!isSplayRoot(p))
+            rotate((left[p] == x) == (left[parent[p]] == p) ? p : x);
+
+        rotate(x);
+    }
+}
+
+/** make the root-to-x path preferred; x ends as root of its splay tree */
+void LinkCutTree::access(int x)
+{
+    int last = -1;
+
+    for(int y = x; y >= 0; y = parent[y])
+    {
+        splay(y);
+        right[y] = last;
+        update(y);
+        last = y;
+    }
+
+    splay(x);
+}
+
+/** make x the root of its tree */
+void LinkCutTree::makeRoot(int x)
+{
+    access(x);
+    flipped[x] ^= 1;
+}
+
+/** get the root of x's tree */
+int LinkCutTree::findRoot(int x)
+{
+    access(x);
+
+    // root is the leftmost (shallowest) node of the path
+    while(true)
+    {
+        pushDown(x);
+        if(left[x] < 0) break;
+        x = left[x];
+    }
+
+    splay(x);
+    return x;
+}
+
+/** check if x and y are in the same tree */
+bool LinkCutTree::connected(int x, int y)
+{
+    return findRoot(x) == findRoot(y);
+}
+
+/** join the trees of x and y by an edge between x and y. They must be
+ *  in different trees
+ */
+void LinkCutTree::link(int x, int y)
+{
+    makeRoot(x);
+    parent[x] = y;
+}
+
+/** remove the edge between x and y. It must exist */
+void LinkCutTree::cut(int x, int y)
+{
+    makeRoot(x);
+    access(y);
+
+    // path is just x - y, so x is y's left child
+    left[y] = -1;
+    parent[x] = -1;
+    update(y);
+}
+
+/** get the node of largest value on the path from x to y. They must be
+ *  in the same tree
+ */
+int LinkCutTree::pathMax(int x, int y)
+{
+    makeRoot(x);
+    access(y);
+
+    return maxNode[y];
+}
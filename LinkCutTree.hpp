@@ -0,0 +1,96 @@
+/**
+ * Filename:     LinkCutTree.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com, Sleator & Tarjan "A Data Structure for
+ *               Dynamic Trees"
+ *
+ * Description:  Link-cut tree (forest of splay trees over preferred paths)
+ *               holding the ActorGraph's minimum spanning forest. Every node
+ *               has a value; the forest can link and cut nodes and find the
+ *               node of largest value on the path between two nodes, each in
+ *               amortized O(log n). Edges are nodes too, so the largest edge
+ *               on a tree path can be found and replaced.
+ */
+
+#ifndef PA4_LINKCUTTREE_HPP
+#define PA4_LINKCUTTREE_HPP
+
+#include <vector>
+#include "MemoryStats.hpp"
+
+using namespace std;
+
+/** Dynamic forest with path-maximum queries. Nodes are ints from addNode */
+class LinkCutTree {
+private:
+    counted_vector<int, MEM_MST> left;     // left child in splay tree, or -1
+    counted_vector<int, MEM_MST> right;    // right child in splay tree, or -1
+    counted_vector<int, MEM_MST> parent;   // splay parent, or path-parent if root of splay, or -1
+    counted_vector<char, MEM_MST> flipped; // children of this splay subtree must be swapped
+    counted_vector<int, MEM_MST> value;    // value of each node
+    counted_vector<int, MEM_MST> maxNode;  // node of largest value in splay subtree
+    counted_vector<int, MEM_MST> tags;     // caller's data of each node
+    counted_vector<int, MEM_MST> above;    // splay scratch: a node and its splay ancestors
+
+    /** check if x is the root of its splay tree */
+    bool isSplayRoot(int x) const;
+
+    /** recompute maxNode of x from its children */
+    void update(int x);
+
+    /** pass a pending flip of x down to its children */
+    void pushDown(int x);
+
+    /** rotate x above its splay parent */
+    void rotate(int x);
+
+    /** bring x to the root of its splay tree */
+    void splay(int x);
+
+    /** make the root-to-x path preferred; x ends as root of its splay tree */
+    void access(int x);
+
+    /** make x the root of its tree */
+    void makeRoot(int x);
+
+    /** get the root of x's tree */
+    int findRoot(int x);
+
+public:
+
+    /** add a node with value val and tag, not linked to anything */
+    int addNode(int val, int tag);
+
+    /** check if x and y are in the same tree */
+    bool connected(int x, int y);
+
+    /** join the trees of x and y by an edge between x and y. They must be
+     *  in different trees
+     */
+    void link(int x, int y);
+
+    /** remove the edge between x and y. It must exist */
+    void cut(int x, int y);
+
+    /** get the node of largest value on the path from x to y. They must be
+     *  in the same tree
+     */
+    int pathMax(int x, int y);
+
+    /** get value of x */
+    int getValue(int x) const {return value[x];}
+
+    /** set value of x. x must not be linked to anything */
+    void setValue(int x, int val) {value[x] = val; maxNode[x] = x;}
+
+    /** get tag of x */
+    int getTag(int x) const {return tags[x];}
+
+    /** number of nodes added */
+    int size() const {return value.size();}
+};
+
+#endif //PA4_LINKCUTTREE_HPP
@@ -0,0 +1,75 @@
+/**
+ * Filename:     MemoryStats.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Memory accounting for the ActorGraph. Containers of the graph
+ *               allocate through CountingAllocator, which charges every
+ *               allocation to one of the structures listed in MemTag. Each
+ *               structure keeps its live bytes, live objects and peak bytes,
+ *               so a report can say where the resident size of a graph goes.
+ */
+
+#include <iomanip>
+#include "MemoryStats.hpp"
+
+MemCounter memCounters[NUM_MEM_TAGS];
+
+/** report name of each structure, by MemTag */
+static const char* const MEM_TAG_NAMES[NUM_MEM_TAGS] = {
+    "movie archive",
+    "movie queue (ordEdges)",
+    "raw incidences",
+    "actor/movie id tables",
+    "incidence lists",
+    "name index",
+    "path search (pq/processed)",
+    "search kernel state",
+    "MST forest",
+};
+
+/** forget the peaks so far; each peak restarts at its live bytes */
+void resetMemPeaks()
+{
+    for(MemCounter& counter : memCounters)
+        counter.peak = counter.bytes.load();
+}
+
+/** write one line per structure: live bytes, peak bytes and live objects.
+ *  Adds the totals of every structure to bytes, peak and objects
+ */
+void writeMemCounters(ostream& out, long long& bytes, long long& peak,
+                      long long& objects)
+{
+    for(int tag = 0; tag < NUM_MEM_TAGS; ++tag)
+    {
+        MemCounter& counter = memCounters[tag];
+
+        writeMemLine(out, MEM_TAG_NAMES[tag], counter.bytes, counter.peak,
+                     counter.objects);
+
+        bytes += counter.bytes;
+        peak += counter.peak;
+        objects += counter.objects;
+    }
+}
+
+/** write the column names of the report lines */
+void writeMemHeader(ostream& out)
+{
+    out << left << setw(28) << "structure" << right
+        << setw(14) << "bytes" << setw(14) << "peak bytes"
+        << setw(12) << "objects" << "\n";
+}
+
+/** write one report line for a structure named name */
+void writeMemLine(ostream& out, const char* name, long long bytes,
+                  long long peak, long long objects)
+{
+    out << left << setw(28) << name << right
+        << setw(14) << bytes << setw(14) << peak
+        << setw(12) << objects << "\n";
+}
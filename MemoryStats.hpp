@@ -0,0 +1,143 @@
+/**
+ * Filename:     MemoryStats.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Memory accounting for the ActorGraph. Containers of the graph
+ *               allocate through CountingAllocator, which charges every
+ *               allocation to one of the structures listed in MemTag. Each
+ *               structure keeps its live bytes, live objects and peak bytes,
+ *               so a report can say where the resident size of a graph goes.
+ */
+
+#ifndef PA4_MEMORYSTATS_HPP
+#define PA4_MEMORYSTATS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/** structures memory is charged to */
+enum MemTag { MEM_MOVIE_ARCHIVE, MEM_MOVIE_QUEUE,
+              MEM_RAW_INCIDENCES, MEM_NODE_TABLES, MEM_INCIDENCE_LISTS,
+              MEM_NAME_INDEX, MEM_PATH_SEARCH, MEM_SEARCH_STATE, MEM_MST,
+              NUM_MEM_TAGS };
+
+/** Live and peak usage of one structure. Updated from any thread */
+struct MemCounter {
+    atomic<long long> bytes;   // bytes allocated and not freed yet
+    atomic<long long> objects; // element slots allocated and not freed yet
+    atomic<long long> peak;    // most bytes live at once since the last reset
+
+    void add(long long size, long long num)
+    {
+        long long now = bytes.fetch_add(size, memory_order_relaxed) + size;
+        long long top = peak.load(memory_order_relaxed);
+
+        objects.fetch_add(num, memory_order_relaxed);
+        while(now > top && !peak.compare_exchange_weak(top, now,
+                                                       memory_order_relaxed));
+    }
+
+    void remove(long long size, long long num)
+    {
+        bytes.fetch_sub(size, memory_order_relaxed);
+        objects.fetch_sub(num, memory_order_relaxed);
+    }
+};
+
+extern MemCounter memCounters[NUM_MEM_TAGS];
+
+/** Allocator that charges its allocations to memCounters[Tag]. Stateless,
+ *  so containers using it behave like ones using std::allocator
+ */
+template <class T, int Tag>
+class CountingAllocator {
+public:
+    typedef T value_type;
+
+    template <class U>
+    struct rebind { typedef CountingAllocator<U, Tag> other; };
+
+    CountingAllocator() {}
+
+    template <class U>
+    CountingAllocator(const CountingAllocator<U, Tag>& other) {}
+
+    T* allocate(size_t num)
+    {
+        memCounters[Tag].add(num * sizeof(T), num);
+        return static_cast<T*>(::operator new(num * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t num)
+    {
+        memCounters[Tag].remove(num * sizeof(T), num);
+        ::operator delete(ptr);
+    }
+};
+
+template <class T, class U, int Tag>
+bool operator==(const CountingAllocator<T, Tag>&, const CountingAllocator<U, Tag>&)
+{
+    return true;
+}
+
+template <class T, class U, int Tag>
+bool operator!=(const CountingAllocator<T, Tag>&, const CountingAllocator<U, Tag>&)
+{
+    return false;
+}
+
+/** vector and deque whose memory is charged to Tag */
+template <class T, int Tag>
+using counted_vector = vector<T, CountingAllocator<T, Tag>>;
+
+template <class T, int Tag>
+using counted_deque = deque<T, CountingAllocator<T, Tag>>;
+
+/** string whose text is charged to Tag once it is too long to be kept
+ *  inside the string object itself
+ */
+template <int Tag>
+using counted_string = basic_string<char, char_traits<char>, CountingAllocator<char, Tag>>;
+
+/** hash of a counted_string's text (FNV-1a) */
+struct CountedStringHash {
+    template <int Tag>
+    size_t operator()(const counted_string<Tag>& key) const
+    {
+        uint64_t h = 0xCBF29CE484222325ULL;
+
+        for(char c : key) h = (h ^ (unsigned char)c) * 0x100000001B3ULL;
+        return h;
+    }
+};
+
+/** forget the peaks so far; each peak restarts at its live bytes */
+void resetMemPeaks();
+
+/** write one line per structure: live bytes, peak bytes and live objects.
+ *  Adds the totals of every structure to bytes, peak and objects
+ */
+void writeMemCounters(ostream& out, long long& bytes, long long& peak,
+                      long long& objects);
+
+/** write the column names of the report lines */
+void writeMemHeader(ostream& out);
+
+/** write one report line for a structure named name */
+void writeMemLine(ostream& out, const char* name, long long bytes,
+                  long long peak, long long objects);
+
+#endif //PA4_MEMORYSTATS_HPP
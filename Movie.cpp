@@ -19,26 +19,12 @@
 /** Create a new movie with weighted or unweighted edge, depending on arg
  *  strength/weight is 1 if unweighted flag set
  */
-Movie::Movie(string& name, int& year, bool useWeight) {
+Movie::Movie(string& name, int& year, bool useWeight, int id) {
     this->name = name;
     this->year = year;
+    this->id = id;
 
     // check for weighted or unweighted graph
     if(useWeight) this->strength = 1 + (2019 - year); // defined by PA guide
     else this->strength = 1;
 }
-
-/** add a new actor to the cast from imdb/input file */
-void Movie::updateCast(Actor* actor)
-{
-    string key = actor->getName();
-
-    // find the actor, if it exists
-    auto castItr = cast.find(key);
-
-    // reject duplicate cast member
-    if(castItr != cast.end()) return;
-
-    // If here, new actor in movie. Update cast
-    cast.insert(actorVal(key, actor));
-}
\ No newline at end of file
@@ -21,7 +21,6 @@
 #include <unordered_map>
 #include "Actor.hpp"
 
-typedef unordered_map<string, Actor*> Cast;
 typedef pair<string, Actor*> actorVal;
 
 using namespace std;
@@ -38,14 +37,14 @@ private:
     string name;
     int year;
     int strength;
+    int id; // index of this movie in the ActorGraph
 
 public:
-    Cast cast; // movie cast
 
     /** Create a new movie with weighted or unweighted edge, depending on arg
      *  strength/weight is 1 if unweighted flag set
      */
-    Movie(string& name, int& year, bool useWeight);
+    Movie(string& name, int& year, bool useWeight, int id);
 
     /** return string reference to this movie's name */
     string& getMovieName() {return this->name;}
@@ -56,8 +55,20 @@ public:
     /** return int to strength connecting cast members */
     int getStrength() {return strength;}
 
-    /** add a new actor to the cast from imdb/input file */
-    void updateCast(Actor* actor);
+    /** return index of this movie in the ActorGraph */
+    int getId() {return id;}
+
+    /** set index of this movie in the ActorGraph */
+    void setId(int id) {this->id = id;}
+
+    /** bytes used by this movie, including its name if stored apart */
+    size_t memoryBytes() const
+    {
+        const char* text = name.data();
+        bool inside = text >= (const char*)this && text < (const char*)(this + 1);
+
+        return sizeof(Movie) + (inside ? 0 : name.capacity() + 1);
+    }
 };
 
 #endif //PA4_MOVIE_HPP
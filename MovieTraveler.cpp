@@ -10,12 +10,17 @@
  *               Writes the MST to a file, listing its edges connecting actors,
  *               as well as the total number of actors, edges, and total weight of the
  *               edges in the MST. The ActorGraph graph is strictly weighted and undirected.
+ *               Files of new movies given with --add are loaded after the MST
+ *               is built and update it, instead of building it again.
  *
  * Arguments: input file, output file
  */
 
 #include <iostream>
 #include <fstream>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
 #include "ActorGraph.hpp"
 
 using namespace std;
@@ -26,13 +31,34 @@ int main(int argc, char** argv)
     ActorGraph graph;
     ofstream mstOutFile;  // output file to write shortest paths for pairs
     const int NUM_ARGS = 3;  // correct number of args
+    bool incidenceStats = false; // print size of compressed graph after load
+    int minYear = 0;             // only use movies released from minYear
+    int maxYear = -1;            // to maxYear, if minYear <= maxYear
+    vector<char*> addFiles;      // files of new movies to add to the MST
+    bool memReport = false;      // print memory of each structure
+
+    // read options following the required args
+    for(int i = NUM_ARGS; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "--incidence-stats")) incidenceStats = true;
+        else if(!strcmp(argv[i], "--years") && i + 2 < argc)
+        {
+            minYear = atoi(argv[++i]);
+            maxYear = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--mem-report")) memReport = true;
+        else if(!strcmp(argv[i], "--add") && i + 1 < argc)
+            addFiles.push_back(argv[++i]);
+        else argc = 0; // unknown option, show usage below
+    }
 
     // check for correct # of args
-    if(argc != NUM_ARGS)
+    if(argc < NUM_ARGS)
     {
         cout << "./movietraveler called with incorrect arguments." << endl
              << "Usage: ./movietraveler movie_cast_tsv_file "
-                "output_paths_tsv_file" << endl;
+                "output_paths_tsv_file [--incidence-stats] [--years min_year max_year]"
+                " [--add new_movies_tsv_file]... [--mem-report]" << endl;
 
         return 0;
     }
@@ -40,6 +66,19 @@ int main(int argc, char** argv)
     // populate graph with unweighted/weighted edges. (u = unweight, w = weight)
     graph.loadFromFile(argv[1], true, true);
 
+    if(incidenceStats) graph.writeIncidenceStats(cout);
+    if(memReport) graph.writeMemoryReport("load", cout);
+
+    // restrict queries to movies inside the year window, if one was given
+    if(minYear <= maxYear) graph.setYearWindow(minYear, maxYear);
+
+    // new movies only replace the edges of the cycles they close
+    if(!addFiles.empty() || memReport) graph.buildMST();
+    if(memReport) graph.writeMemoryReport("MST", cout);
+
+    for(char* addFile : addFiles)
+        graph.loadFromFile(addFile, true, true);
+
     // open file to write minimum spanning tree of graph
     mstOutFile.open(argv[2]);
 
@@ -0,0 +1,482 @@
+/**
+ * Filename:     NameIndex.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Index from actor name to actor id, which loads intern
+ *               new names into as they read them. Names are
+ *               interned back to back in one buffer as records of length,
+ *               name and id. Exact lookups go through a perfect hash (hash
+ *               and displace): one hash of the name, one seed, one slot
+ *               pointing at a record, one compare. A copy of the ids sorted
+ *               by name answers prefix queries. Names added after the build
+ *               go to a small open addressing table, and a sorted list once
+ *               their load settles, until there are enough of them to
+ *               rebuild.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "NameIndex.hpp"
+
+static const uint32_t EMPTY = 0xFFFFFFFF;        // slot holding no name
+static const uint64_t MUL = 0x9E3779B97F4A7C15ULL; // odd mixing constant
+static const uint32_t MAX_SEED = 0xFFFF;          // last seed tried per bucket
+static const uint64_t MAX_SALTS = 8;              // salts tried per table size
+
+const int NameIndex::UNKNOWN;
+
+/** check if name a sorts before name b (byte-wise, shorter first on ties) */
+static bool nameLess(const char* a, size_t lenA, const char* b, size_t lenB)
+{
+    int cmp = memcmp(a, b, min(lenA, lenB));
+    return cmp < 0 || (cmp == 0 && lenA < lenB);
+}
+
+/** build the index over names, which must be distinct; name i gets id i */
+void NameIndex::build(const vector<string>& names)
+{
+    chars = counted_vector<char, MEM_NAME_INDEX>();
+    starts = counted_vector<uint32_t, MEM_NAME_INDEX>();
+    starts.reserve(names.size());
+
+    // intern all names into one buffer, with their length and id
+    for(uint32_t id = 0; id < names.size(); ++id)
+        addRecord(names[id].data(), names[id].size(), id);
+
+    indexRecords();
+}
+
+/** order the ids of every record by name and place them all in a
+ *  new perfect hash, dropping the table of added names
+ */
+void NameIndex::indexRecords()
+{
+    extra = counted_vector<uint32_t, MEM_NAME_INDEX>();
+    extraSorted = counted_vector<uint32_t, MEM_NAME_INDEX>();
+    numSettled = starts.size();
+    chars.shrink_to_fit();
+    starts.shrink_to_fit();
+
+    // ids in name order for prefix queries
+    sorted.resize(starts.size());
+    for(unsigned int i = 0; i < sorted.size(); ++i)
+        sorted[i] = i;
+
+    sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b)
+         {
+             uint32_t lenA, lenB;
+             const char* nameA = nameAt(starts[a], lenA);
+             const char* nameB = nameAt(starts[b], lenB);
+
+             return nameLess(nameA, lenA, nameB, lenB);
+         });
+
+    // about 4 names per bucket and 80% of slots filled
+    uint32_t numBuckets = sorted.size() / 4 + 1;
+    uint32_t numSlots = sorted.size() + sorted.size() / 4 + 1;
+
+    /** a different salt reshuffles every bucket if some bucket got stuck.
+     *  If a few salts all fail, smaller buckets in a sparser table place
+     *  more easily, so grow both and start over
+     */
+    while(true)
+    {
+        for(salt = 0; salt < MAX_SALTS; ++salt)
+            if(placeAll(numBuckets, numSlots)) return;
+
+        numBuckets *= 2;
+        numSlots += numSlots / 2;
+    }
+}
+
+/** get the id of name, of len bytes. A name not in the index yet is
+ *  added with the next id, and added is set. Added names are found at
+ *  once, but only answer prefix queries after settle
+ */
+int NameIndex::intern(const char* name, size_t len, bool& added)
+{
+    int id = findName(name, len);
+
+    added = id == UNKNOWN;
+    if(!added) return id;
+
+    id = starts.size();
+    addRecord(name, len, id);
+    insertExtra(starts[id]);
+    extraSorted.push_back(id);
+
+    return id;
+}
+
+/** finish the names added by intern: put them in name order for prefix
+ *  queries. The perfect hash is only rebuilt once the names added since
+ *  it was built pass a quarter of it
+ */
+void NameIndex::settle()
+{
+    size_t numOld = extraSorted.size() - (starts.size() - numSettled); // added names already in order
+
+    if(sorted.empty() || extraSorted.size() * 4 > sorted.size())
+    {
+        indexRecords();
+        return;
+    }
+
+    numSettled = starts.size();
+
+    // sort the new ids by name, then merge them with the earlier ones
+    auto byName = [this](uint32_t a, uint32_t b)
+    {
+        uint32_t lenA, lenB;
+        const char* nameA = nameAt(starts[a], lenA);
+        const char* nameB = nameAt(starts[b], lenB);
+
+        return nameLess(nameA, lenA, nameB, lenB);
+    };
+
+    sort(extraSorted.begin() + numOld, extraSorted.end(), byName);
+    inplace_merge(extraSorted.begin(), extraSorted.begin() + numOld,
+                  extraSorted.end(), byName);
+}
+
+/** drop every name with id numNames or above. They must all have been
+ *  added since the last settle
+ */
+void NameIndex::truncate(int numNames)
+{
+    if((size_t)numNames >= starts.size()) return;
+
+    chars.resize(starts[numNames]);
+    starts.resize(numNames);
+
+    // names past the built ones are all added names; the dropped ones came last
+    extraSorted.resize(numNames - sorted.size());
+
+    extra.assign(extra.size(), EMPTY);
+    for(uint32_t id : extraSorted)
+        placeExtra(starts[id]);
+}
+
+/** append the record of name, of len bytes, with id to chars */
+void NameIndex::addRecord(const char* name, size_t len, uint32_t id)
+{
+    uint32_t rest = len; // length bytes still to write, 7 bits each
+
+    starts.push_back(chars.size());
+
+    for(; rest >= 0x80; rest >>= 7)
+        chars.push_back((char)(rest | 0x80));
+    chars.push_back((char)rest);
+
+    chars.insert(chars.end(), name, name + len);
+    chars.insert(chars.end(), (char*)&id, (char*)&id + sizeof(id));
+}
+
+/** put the record at offset rec in the table of added names */
+void NameIndex::insertExtra(uint32_t rec)
+{
+    // keep the table at most half full, so probes stay short
+    if((extraSorted.size() + 1) * 2 > extra.size())
+    {
+        extra.assign(max((size_t)16, extra.size() * 2), EMPTY);
+
+        for(uint32_t id : extraSorted)
+            placeExtra(starts[id]);
+    }
+
+    placeExtra(rec);
+}
+
+/** put the record at offset rec in the first free slot of its probe
+ *  sequence, which must have one
+ */
+void NameIndex::placeExtra(uint32_t rec)
+{
+    uint32_t len;
+    const char* name = nameAt(rec, len);
+    uint32_t slot = hashName(name, len) & (extra.size() - 1);
+
+    while(extra[slot] != EMPTY)
+        slot = (slot + 1) & (extra.size() - 1);
+
+    extra[slot] = rec;
+}
+
+/** get the id of name among the names added since build, or UNKNOWN */
+int NameIndex::findExtra(const char* name, size_t len) const
+{
+    if(extra.empty()) return UNKNOWN;
+
+    uint32_t slot = hashName(name, len) & (extra.size() - 1);
+
+    for(; extra[slot] != EMPTY; slot = (slot + 1) & (extra.size() - 1))
+        if(matches(extra[slot], name, len)) return idAt(extra[slot]);
+
+    return UNKNOWN;
+}
+
+/** try to place every name with the current salt in a table of
+ *  numBuckets buckets and numSlots slots. false if some bucket ran out
+ *  of seeds
+ */
+bool NameIndex::placeAll(uint32_t numBuckets, uint32_t numSlots)
+{
+    uint32_t numNames = sorted.size();
+    vector<uint64_t> hashes(numNames);  // hash of each name
+    vector<uint32_t> bucketEnd;         // members of bucket b end here
+    vector<uint32_t> members(numNames); // ids grouped by bucket
+    vector<uint32_t> order;             // buckets, largest first
+    vector<uint32_t> placed;            // slots taken by the current bucket
+
+    seeds.assign(numBuckets, 0);
+    slots.assign(numSlots, EMPTY);
+    bucketEnd.assign(seeds.size() + 1, 0);
+
+    // group ids by bucket (counting sort)
+    for(uint32_t id = 0; id < numNames; ++id)
+    {
+        uint32_t len;
+        const char* name = nameAt(starts[id], len);
+
+        hashes[id] = hashName(name, len);
+        ++bucketEnd[bucketOf(hashes[id]) + 1];
+    }
+
+    for(unsigned int b = 1; b < bucketEnd.size(); ++b)
+        bucketEnd[b] += bucketEnd[b - 1];
+
+    vector<uint32_t> fill(bucketEnd.begin(), bucketEnd.end() - 1);
+    for(uint32_t id = 0; id < numNames; ++id)
+        members[fill[bucketOf(hashes[id])]++] = id;
+
+    /** place big buckets first, while the table is still mostly empty */
+    order.resize(seeds.size());
+    for(unsigned int b = 0; b < order.size(); ++b)
+        order[b] = b;
+
+    stable_sort(order.begin(), order.end(), [&bucketEnd](uint32_t a, uint32_t b)
+                { return bucketEnd[a + 1] - bucketEnd[a] >
+                         bucketEnd[b + 1] - bucketEnd[b]; });
+
+    for(uint32_t b : order)
+    {
+        if(bucketEnd[b + 1] == bucketEnd[b]) break; // only empty buckets left
+
+        uint32_t seed;
+
+        // find a seed sending every member of the bucket to a free slot
+        for(seed = 0; seed <= MAX_SEED; ++seed)
+        {
+            placed.clear();
+
+            for(uint32_t i = bucketEnd[b]; i < bucketEnd[b + 1]; ++i)
+            {
+                uint32_t slot = slotOf(hashes[members[i]], seed);
+
+                if(slots[slot] != EMPTY ||
+                        std::find(placed.begin(), placed.end(), slot) != placed.end())
+                    break;
+
+                placed.push_back(slot);
+            }
+
+            if(placed.size() == bucketEnd[b + 1] - bucketEnd[b]) break;
+        }
+
+        if(seed > MAX_SEED) return false;
+
+        // claim the slots for this bucket
+        seeds[b] = seed;
+        for(unsigned int i = 0; i < placed.size(); ++i)
+            slots[placed[i]] = starts[members[bucketEnd[b] + i]];
+    }
+
+    return true;
+}
+
+/** hash of a name, computed once per lookup */
+uint64_t NameIndex::hashName(const char* name, size_t len) const
+{
+    uint64_t h = salt ^ (len * MUL);
+    uint64_t word;
+
+    // mix 8 bytes at a time, then the leftover tail
+    for(; len >= 8; name += 8, len -= 8)
+    {
+        memcpy(&word, name, 8);
+        h = (h ^ word) * MUL;
+        h ^= h >> 29;
+    }
+
+    word = 0;
+    memcpy(&word, name, len);
+    h = (h ^ word) * MUL;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/** bucket of a name with hash h */
+uint32_t NameIndex::bucketOf(uint64_t h) const
+{
+    // map the high 32 bits onto [0, buckets) without a division
+    return ((h >> 32) * seeds.size()) >> 32;
+}
+
+/** slot of a name with hash h in the table, given its bucket's seed */
+uint32_t NameIndex::slotOf(uint64_t h, uint16_t seed) const
+{
+    uint64_t x = h ^ ((seed + 1) * MUL);
+
+    x ^= x >> 31;
+    x *= 0x7FB5D329728EA185ULL;
+    x ^= x >> 27;
+
+    return ((x & 0xFFFFFFFF) * slots.size()) >> 32;
+}
+
+/** get the id in the record at offset rec */
+uint32_t NameIndex::idAt(uint32_t rec) const
+{
+    uint32_t len;
+    uint32_t id;
+    const char* name = nameAt(rec, len);
+
+    // id is stored right after the name, possibly unaligned
+    memcpy(&id, name + len, sizeof(id));
+    return id;
+}
+
+/** check if the record at offset rec holds name */
+bool NameIndex::matches(uint32_t rec, const char* name, size_t len) const
+{
+    if(rec == EMPTY) return false;
+
+    uint32_t recLen;
+    const char* recName = nameAt(rec, recLen);
+
+    return recLen == len && !memcmp(recName, name, len);
+}
+
+/** get the id of name, or UNKNOWN */
+int NameIndex::find(const string& name) const
+{
+    return findName(name.data(), name.size());
+}
+
+/** get the id of name, of len bytes, or UNKNOWN */
+int NameIndex::findName(const char* name, size_t len) const
+{
+    if(!sorted.empty())
+    {
+        uint64_t h = hashName(name, len);
+        uint32_t rec = slots[slotOf(h, seeds[bucketOf(h)])];
+
+        // any other name can land on the slot too, so compare
+        if(matches(rec, name, len)) return idAt(rec);
+    }
+
+    return findExtra(name, len);
+}
+
+/** get the id of every name in names at once, or UNKNOWN for each
+ *  name not in the index. Hashes all names first so the table reads
+ *  can be overlapped
+ */
+void NameIndex::findAll(const vector<string>& names, vector<int>& ids) const
+{
+    vector<uint64_t> hashes(names.size());
+    vector<uint32_t> slotOfName(names.size());
+
+    ids.assign(names.size(), UNKNOWN);
+    if(sorted.empty()) return;
+
+    // pass 1: hash every name and start loading its seed
+    for(unsigned int i = 0; i < names.size(); ++i)
+    {
+        hashes[i] = hashName(names[i].data(), names[i].size());
+        __builtin_prefetch(&seeds[bucketOf(hashes[i])]);
+    }
+
+    // pass 2: find every slot and start loading it
+    for(unsigned int i = 0; i < names.size(); ++i)
+    {
+        slotOfName[i] = slotOf(hashes[i], seeds[bucketOf(hashes[i])]);
+        __builtin_prefetch(&slots[slotOfName[i]]);
+    }
+
+    // pass 3: read every slot and start loading its record
+    for(unsigned int i = 0; i < names.size(); ++i)
+    {
+        slotOfName[i] = slots[slotOfName[i]];
+        if(slotOfName[i] != EMPTY)
+            __builtin_prefetch(chars.data() + slotOfName[i]);
+    }
+
+    // pass 4: confirm each name against the interned name in its record
+    for(unsigned int i = 0; i < names.size(); ++i)
+    {
+        if(matches(slotOfName[i], names[i].data(), names[i].size()))
+            ids[i] = idAt(slotOfName[i]);
+        else
+            ids[i] = findExtra(names[i].data(), names[i].size());
+    }
+}
+
+/** append to ids, in lexicographic order, every id whose name starts
+ *  with prefix
+ */
+void NameIndex::findPrefix(const string& prefix, vector<int>& ids) const
+{
+    size_t first = ids.size(); // matches of the built names start here
+
+    findPrefixIn(sorted, prefix, ids);
+    if(extraSorted.empty()) return;
+
+    size_t middle = ids.size(); // matches of the added names start here
+
+    findPrefixIn(extraSorted, prefix, ids);
+
+    inplace_merge(ids.begin() + first, ids.begin() + middle, ids.end(),
+                  [this](int a, int b)
+                  {
+                      uint32_t lenA, lenB;
+                      const char* nameA = nameAt(starts[a], lenA);
+                      const char* nameB = nameAt(starts[b], lenB);
+
+                      return nameLess(nameA, lenA, nameB, lenB);
+                  });
+}
+
+/** append to ids, in order, every id of order whose name starts with
+ *  prefix. order holds ids in lexicographic order of their names
+ */
+void NameIndex::findPrefixIn(const counted_vector<uint32_t, MEM_NAME_INDEX>& order,
+                             const string& prefix, vector<int>& ids) const
+{
+    // first name not sorting before prefix
+    auto itr = lower_bound(order.begin(), order.end(), prefix,
+                           [this](uint32_t id, const string& key)
+                           {
+                               uint32_t len;
+                               const char* name = nameAt(starts[id], len);
+
+                               return nameLess(name, len, key.data(), key.size());
+                           });
+
+    // names starting with prefix are all next to each other from there
+    for(; itr != order.end(); ++itr)
+    {
+        uint32_t len;
+        const char* name = nameAt(starts[*itr], len);
+
+        if(len < prefix.size() || memcmp(name, prefix.data(), prefix.size()))
+            break;
+
+        ids.push_back(*itr);
+    }
+}
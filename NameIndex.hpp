@@ -0,0 +1,172 @@
+/**
+ * Filename:     NameIndex.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Index from actor name to actor id, which loads intern
+ *               new names into as they read them. Names are
+ *               interned back to back in one buffer as records of length,
+ *               name and id. Exact lookups go through a perfect hash (hash
+ *               and displace): one hash of the name, one seed, one slot
+ *               pointing at a record, one compare. A copy of the ids sorted
+ *               by name answers prefix queries. Names added after the build
+ *               go to a small open addressing table, and a sorted list once
+ *               their load settles, until there are enough of them to
+ *               rebuild.
+ */
+
+#ifndef PA4_NAMEINDEX_HPP
+#define PA4_NAMEINDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MemoryStats.hpp"
+
+using namespace std;
+
+/** Perfect hash + sorted order over a set of names. Ids are the order in
+ *  which names were built or interned; the graph gives each actor the id
+ *  of its name.
+ */
+class NameIndex {
+private:
+    counted_vector<char, MEM_NAME_INDEX> chars;      // every record (varint length, name, id), back to back
+    counted_vector<uint32_t, MEM_NAME_INDEX> starts; // record of name i starts at starts[i]
+    counted_vector<uint16_t, MEM_NAME_INDEX> seeds;  // displacement seed of each hash bucket
+    counted_vector<uint32_t, MEM_NAME_INDEX> slots;  // record held in each slot of the table, or EMPTY
+    counted_vector<uint32_t, MEM_NAME_INDEX> sorted; // ids in lexicographic order of their names
+    counted_vector<uint32_t, MEM_NAME_INDEX> extra;  // records of names added since build, by linear probing, or EMPTY
+    counted_vector<uint32_t, MEM_NAME_INDEX> extraSorted; // ids added since build, in name order up to numSettled
+    uint32_t numSettled;       // names held at the last build or settle
+    uint64_t salt;             // mixed into every hash; changed on rebuilds
+
+    /** hash of a name, computed once per lookup */
+    uint64_t hashName(const char* name, size_t len) const;
+
+    /** slot of a name with hash h in the table, given its bucket's seed */
+    uint32_t slotOf(uint64_t h, uint16_t seed) const;
+
+    /** bucket of a name with hash h */
+    uint32_t bucketOf(uint64_t h) const;
+
+    /** get the name in the record at offset rec, and its length in len */
+    const char* nameAt(uint32_t rec, uint32_t& len) const
+    {
+        const char* pos = chars.data() + rec;
+        int shift = 0;
+
+        for(len = 0; *pos & 0x80; shift += 7)
+            len |= (uint32_t)(*pos++ & 0x7F) << shift;
+        len |= (uint32_t)*pos++ << shift;
+
+        return pos;
+    }
+
+    /** append the record of name, of len bytes, with id to chars */
+    void addRecord(const char* name, size_t len, uint32_t id);
+
+    /** order the ids of every record by name and place them all in a
+     *  new perfect hash, dropping the table of added names
+     */
+    void indexRecords();
+
+    /** put the record at offset rec in the table of added names */
+    void insertExtra(uint32_t rec);
+
+    /** put the record at offset rec in the first free slot of its probe
+     *  sequence, which must have one
+     */
+    void placeExtra(uint32_t rec);
+
+    /** get the id of name, of len bytes, or UNKNOWN */
+    int findName(const char* name, size_t len) const;
+
+    /** get the id of name among the names added since build, or UNKNOWN */
+    int findExtra(const char* name, size_t len) const;
+
+    /** append to ids, in order, every id of order whose name starts with
+     *  prefix. order holds ids in lexicographic order of their names
+     */
+    void findPrefixIn(const counted_vector<uint32_t, MEM_NAME_INDEX>& order,
+                      const string& prefix, vector<int>& ids) const;
+
+    /** get the id in the record at offset rec */
+    uint32_t idAt(uint32_t rec) const;
+
+    /** check if the record at offset rec holds name */
+    bool matches(uint32_t rec, const char* name, size_t len) const;
+
+    /** try to place every name with the current salt in a table of
+     *  numBuckets buckets and numSlots slots. false if some bucket ran out
+     *  of seeds
+     */
+    bool placeAll(uint32_t numBuckets, uint32_t numSlots);
+
+public:
+    static const int UNKNOWN = -1; // id returned for a name not in the index
+
+    NameIndex() : numSettled(0), salt(0) {}
+
+    /** build the index over names, which must be distinct; name i gets id i */
+    void build(const vector<string>& names);
+
+    /** get the id of name, of len bytes. A name not in the index yet is
+     *  added with the next id, and added is set. Added names are found at
+     *  once, but only answer prefix queries after settle
+     */
+    int intern(const char* name, size_t len, bool& added);
+
+    /** finish the names added by intern: put them in name order for prefix
+     *  queries. The perfect hash is only rebuilt once the names added since
+     *  it was built pass a quarter of it
+     */
+    void settle();
+
+    /** drop every name with id numNames or above. They must all have been
+     *  added since the last settle
+     */
+    void truncate(int numNames);
+
+    /** get the id of name, or UNKNOWN */
+    int find(const string& name) const;
+
+    /** get the id of every name in names at once, or UNKNOWN for each
+     *  name not in the index. Hashes all names first so the table reads
+     *  can be overlapped
+     */
+    void findAll(const vector<string>& names, vector<int>& ids) const;
+
+    /** append to ids, in lexicographic order, every id whose name starts
+     *  with prefix
+     */
+    void findPrefix(const string& prefix, vector<int>& ids) const;
+
+    /** get the interned name with id */
+    string getName(int id) const
+    {
+        uint32_t len;
+        const char* name = nameAt(starts[id], len);
+
+        return string(name, len);
+    }
+
+    /** number of names held */
+    int size() const {return starts.size();}
+
+    /** bytes used by the names, hash tables and sorted orders */
+    size_t memoryBytes() const
+    {
+        return chars.capacity() + starts.capacity() * sizeof(uint32_t)
+               + seeds.capacity() * sizeof(uint16_t)
+               + slots.capacity() * sizeof(uint32_t)
+               + sorted.capacity() * sizeof(uint32_t)
+               + extra.capacity() * sizeof(uint32_t)
+               + extraSorted.capacity() * sizeof(uint32_t);
+    }
+};
+
+#endif //PA4_NAMEINDEX_HPP
@@ -11,11 +11,13 @@
  *               input file, creates a weighted/unweighted graph as specified
  *               by user, read a file containing origin, destination actor pairs
  *               to find a shortest path between, and writes each path
- *               between pairs to an output file.
+ *               between pairs to an output file. With --workers the pairs
+ *               are split among processes forked after the graph is loaded.
  */
 
 #include <iostream>
 #include <fstream>
+#include <stdlib.h>
 #include <string.h>
 #include "ActorGraph.hpp"
 
@@ -28,13 +30,86 @@ int main(int argc, char* argv[])
     ifstream allPairs;   // to read all origin, destination pairs
     ofstream pathsFile;  // output file to write shortest paths for pairs
     const int NUM_ARGS = 5;  // correct number of args
+    bool incidenceStats = false; // print size of compressed graph after load
+    int minYear = 0;             // only use movies released from minYear
+    int maxYear = -1;            // to maxYear, if minYear <= maxYear
+    char* prefix = nullptr;      // print actors whose names start with prefix
+    int maxHops = -1;            // longest path accepted, in movies
+    int maxStrength = -1;        // longest path accepted, in total strength
+    const char* frontier = nullptr; // search frontier (fifo/heap/bucket/generic)
+    const char* weights = nullptr;  // search weights (unit/year/custom)
+    int numWorkers = 1;          // processes answering the pairs
+    int workerTimeout = 600;     // seconds a worker may spend on a chunk of pairs
+    bool answered;               // false if workers gave up on some pairs
+    bool memReport = false;      // print memory of each structure
+    int numPaths = 1;            // shortest simple paths written per pair
+
+    // read options following the required args
+    for(int i = NUM_ARGS; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "--incidence-stats")) incidenceStats = true;
+        else if(!strcmp(argv[i], "--years") && i + 2 < argc)
+        {
+            minYear = atoi(argv[++i]);
+            maxYear = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--suggest") && i + 1 < argc)
+            prefix = argv[++i];
+        else if(!strcmp(argv[i], "--max-hops") && i + 1 < argc)
+            maxHops = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--max-weight") && i + 1 < argc)
+            maxStrength = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--kernel") && i + 1 < argc)
+        {
+            frontier = argv[++i];
+
+            // a typo must not quietly run another search
+            if(strcmp(frontier, "fifo") && strcmp(frontier, "heap")
+               && strcmp(frontier, "bucket") && strcmp(frontier, "generic"))
+                argc = 0;
+        }
+        else if(!strcmp(argv[i], "--weights") && i + 1 < argc)
+        {
+            weights = argv[++i];
+
+            if(strcmp(weights, "unit") && strcmp(weights, "year")
+               && strcmp(weights, "custom"))
+                argc = 0;
+        }
+        else if(!strcmp(argv[i], "--mem-report")) memReport = true;
+        else if(!strcmp(argv[i], "--k") && i + 1 < argc)
+            numPaths = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--workers") && i + 1 < argc)
+            numWorkers = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--worker-timeout") && i + 1 < argc)
+            workerTimeout = atoi(argv[++i]);
+        else argc = 0; // unknown option, show usage below
+    }
 
     // check for correct # of args
-    if(argc != NUM_ARGS)
+    if(argc < NUM_ARGS)
     {
         cout << "./pathfinder called with incorrect arguments." << endl
              << "Usage: ./refpathfinder movie_cast_tsv_file u/w pairs_tsv_file "
-                "output_paths_tsv_file" << endl;
+                "output_paths_tsv_file [--incidence-stats] [--years min_year max_year] "
+                "[--suggest name_prefix] [--max-hops num_movies] "
+                "[--max-weight total_weight] "
+                "[--kernel fifo/heap/bucket/generic] "
+                "[--weights unit/year/custom] "
+                "[--workers num_processes] [--worker-timeout seconds] "
+                "[--mem-report] [--k num_paths]" << endl;
+
+        return 0;
+    }
+
+    /** counters only see this process, while workers answer the pairs in
+     *  their own processes; a report would leave the query batch out
+     */
+    if(memReport && numWorkers > 1)
+    {
+        cout << "./pathfinder: --mem-report cannot be used with --workers "
+                "above 1; the query memory is used by the worker processes "
+                "and would not be reported." << endl;
 
         return 0;
     }
@@ -47,17 +122,58 @@ int main(int argc, char* argv[])
     // last arg is false because this is not movie traveler
     graph.loadFromFile(argv[1], *argv[2] == 'w', false);
 
+    if(incidenceStats) graph.writeIncidenceStats(cout);
+    if(memReport) graph.writeMemoryReport("load", cout);
+
+    // restrict queries to movies inside the year window, if one was given
+    if(minYear <= maxYear) graph.setYearWindow(minYear, maxYear);
+
+    // only accept paths within these bounds, if given
+    graph.setSearchBounds(maxHops, maxStrength);
+
+    /** pick the search once for the whole run. Defaults to BFS when
+     *  unweighted, and a bucket queue on year weights when weighted
+     */
+    if(!weights) weights = *argv[2] == 'w' ? "year" : "unit";
+    if(!frontier) frontier = *argv[2] == 'w' ? "bucket" : "fifo";
+
+    // both names were checked against these lists when parsed
+    WeightPolicy weightPolicy = !strcmp(weights, "unit") ? UNIT_WEIGHT
+                              : !strcmp(weights, "year") ? YEAR_WEIGHT
+                              : CUSTOM_WEIGHT;
+    FrontierPolicy frontierPolicy = !strcmp(frontier, "fifo") ? FIFO_FRONTIER
+                                  : !strcmp(frontier, "heap") ? HEAP_FRONTIER
+                                  : !strcmp(frontier, "bucket") ? BUCKET_FRONTIER
+                                  : GENERIC_SEARCH;
+
+    if(!graph.selectKernel(weightPolicy, frontierPolicy))
+        cerr << "Search " << frontier << " cannot order " << weights
+             << " weights; using generic search." << endl;
+
+    // pairs are answered by worker processes sharing the loaded graph
+    graph.setWorkers(numWorkers, workerTimeout);
+    graph.setPathCount(numPaths);
+
+    // list actors matching the prefix, for name suggestions
+    if(prefix) graph.writeActorsWithPrefix(prefix, cout);
+
     // loop through pairs file
     allPairs.open(argv[3]); // open file of pairs to find shortest path (arg 3)
     pathsFile.open(argv[4]); // open file to write shortest paths to
 
+    // peak bytes below are the highest reached while answering the pairs
+    if(memReport) graph.resetMemoryPeaks();
+
     // write shortest path between all pairs in pairs file
-    graph.writeShortestPaths(allPairs, pathsFile);
+    answered = graph.writeShortestPaths(allPairs, pathsFile);
+
+    if(memReport) graph.writeMemoryReport("query batch", cout);
 
     // close all i/o files
     allPairs.close();
     pathsFile.close();
     // done
 
-    return 0;
+    // pairs the workers gave up on were reported on stderr
+    return answered ? 0 : 1;
 }
\ No newline at end of file
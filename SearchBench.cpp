@@ -0,0 +1,83 @@
+/**
+ * Filename:     SearchBench.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Benchmark driver for the shortest path searches. Loads an
+ *               ActorGraph, then runs the same pairs file through the
+ *               original search and through every specialized search that
+ *               matches the graph's weights, printing the time of each and
+ *               its speedup over the original.
+ *
+ * Arguments: input file, u/w, pairs file
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "ActorGraph.hpp"
+
+using namespace std;
+
+/** Main driver of SearchBench implementation. */
+int main(int argc, char* argv[])
+{
+    ActorGraph graph;
+    ifstream allPairs;        // to read all origin, destination pairs
+    stringstream pairsText;   // pairs file, replayed for every search
+    const int NUM_ARGS = 4;   // correct number of args
+    const char* FRONTIERS[] = {"generic", "fifo", "heap", "bucket"};
+    const char* WEIGHTS[] = {"unit", "year", "custom"};
+    double genericTime = 0;   // seconds taken by the original search
+
+    // check for correct # of args
+    if(argc != NUM_ARGS)
+    {
+        cout << "./searchbench called with incorrect arguments." << endl
+             << "Usage: ./searchbench movie_cast_tsv_file u/w pairs_tsv_file"
+             << endl;
+
+        return 0;
+    }
+
+    bool useWeight = *argv[2] == 'w';
+    graph.loadFromFile(argv[1], useWeight, false);
+
+    allPairs.open(argv[3]);
+    pairsText << allPairs.rdbuf();
+    allPairs.close();
+
+    // original search first, as the baseline for every other
+    for(int f = GENERIC_SEARCH; f <= BUCKET_FRONTIER; ++f)
+    {
+        for(int w = UNIT_WEIGHT; w <= CUSTOM_WEIGHT; ++w)
+        {
+            // only weights giving the same paths as the loaded graph
+            if(w == (useWeight ? UNIT_WEIGHT : YEAR_WEIGHT)) continue;
+
+            // original search ignores weight policy; time it once
+            if(f == GENERIC_SEARCH && w != CUSTOM_WEIGHT) continue;
+            if(!graph.selectKernel((WeightPolicy)w, (FrontierPolicy)f)) continue;
+
+            istringstream pairs(pairsText.str());
+            ostringstream paths;
+
+            auto start = chrono::steady_clock::now();
+            graph.writeShortestPaths(pairs, paths);
+            chrono::duration<double> time = chrono::steady_clock::now() - start;
+
+            if(f == GENERIC_SEARCH) genericTime = time.count();
+
+            cout << WEIGHTS[w] << "/" << FRONTIERS[f] << ": "
+                 << time.count() << " s, "
+                 << genericTime / time.count() << "x generic, "
+                 << paths.str().size() << " bytes written" << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * Filename:     SearchKernel.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Building blocks of the compile-time specialized shortest
+ *               path search in ActorGraph. A weight policy says what a movie
+ *               costs, a frontier policy says how reached actors are ordered.
+ *               The search is instantiated once per useful pair, so a unit
+ *               weight search never loads a Movie and a FIFO frontier never
+ *               compares distances. SearchState holds the per-query arrays.
+ */
+
+#ifndef PA4_SEARCHKERNEL_HPP
+#define PA4_SEARCHKERNEL_HPP
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "MemoryStats.hpp"
+#include "Movie.hpp"
+
+using namespace std;
+
+/** how a movie's weight is chosen */
+enum WeightPolicy { UNIT_WEIGHT, YEAR_WEIGHT, CUSTOM_WEIGHT };
+
+/** how reached actors are ordered. GENERIC_SEARCH is the original
+ *  Actor-based Dijkstra in ActorGraph::getShortestPath
+ */
+enum FrontierPolicy { GENERIC_SEARCH, FIFO_FRONTIER, HEAP_FRONTIER,
+                      BUCKET_FRONTIER };
+
+/** every movie costs 1, so distance is the number of movies */
+struct UnitWeight {
+    static const bool UNIT = true;
+    static int weight(Movie* movie) {return 1;}
+};
+
+/** movie costs 1 + (2019 - year), as defined by PA guide */
+struct YearWeight {
+    static const bool UNIT = false;
+    static int weight(Movie* movie) {return 1 + (2019 - movie->getMovieYear());}
+};
+
+/** movie costs the strength it was loaded with */
+struct CustomWeight {
+    static const bool UNIT = false;
+    static int weight(Movie* movie) {return movie->getStrength();}
+};
+
+class SearchState;
+
+/** Queue in order of arrival. Only correct for unit weights (BFS), where
+ *  the first time an actor is reached is already its shortest path
+ */
+class FifoFrontier {
+private:
+    counted_vector<int, MEM_SEARCH_STATE> queue; // actor ids, popped from head onwards
+    unsigned int head; // next actor id to pop
+
+public:
+    static const bool EXIT_ON_REACH = true; // reached dest is final
+
+    FifoFrontier() : head(0) {}
+
+    static FifoFrontier& in(SearchState& state);
+
+    void clear(int span) {queue.clear(); head = 0;}
+    bool empty() const {return head == queue.size();}
+    void push(int actorId, int dist) {queue.push_back(actorId);}
+    int pop() {return queue[head++];}
+};
+
+/** Binary heap on distance. Works for any non-negative weights */
+class HeapFrontier {
+private:
+    typedef pair<int, int> entry; // <dist, actor id>
+    typedef priority_queue<entry, counted_vector<entry, MEM_SEARCH_STATE>,
+                           greater<entry>> entry_heap;
+    entry_heap heap;
+
+public:
+    static const bool EXIT_ON_REACH = false;
+
+    static HeapFrontier& in(SearchState& state);
+
+    void clear(int span) {heap = entry_heap();}
+    bool empty() const {return heap.empty();}
+    void push(int actorId, int dist) {heap.push(entry(dist, actorId));}
+    int pop() {int id = heap.top().second; heap.pop(); return id;}
+};
+
+/** Circular bucket queue (Dial). Queued distances are always within one
+ *  max edge weight of the smallest, so span buckets indexed by distance
+ *  modulo span cover all of them. Push and pop are O(1)
+ */
+class BucketFrontier {
+private:
+    typedef counted_vector<int, MEM_SEARCH_STATE> bucket;
+    counted_vector<bucket, MEM_SEARCH_STATE> buckets; // actor ids by distance modulo span
+    unsigned int mask;           // span - 1; span is a power of two
+    unsigned int curr;           // distance of the bucket being popped
+    unsigned int count;          // actor ids queued over all buckets
+
+public:
+    static const bool EXIT_ON_REACH = false;
+
+    BucketFrontier() : mask(0), curr(0), count(0) {}
+
+    static BucketFrontier& in(SearchState& state);
+
+    /** span must exceed the largest edge weight */
+    void clear(int span)
+    {
+        unsigned int size = 1;
+        while(size < (unsigned int)span) size <<= 1;
+
+        if(buckets.size() != size) buckets.assign(size, bucket());
+        else if(count)
+            for(bucket& ids : buckets) ids.clear();
+
+        mask = size - 1;
+        curr = count = 0;
+    }
+
+    bool empty() const {return count == 0;}
+
+    void push(int actorId, int dist)
+    {
+        buckets[dist & mask].push_back(actorId);
+        ++count;
+    }
+
+    int pop()
+    {
+        while(buckets[curr & mask].empty()) ++curr;
+
+        int id = buckets[curr & mask].back();
+        buckets[curr & mask].pop_back();
+        --count;
+        return id;
+    }
+};
+
+/** Per-query search arrays indexed by actor id, plus one frontier of each
+ *  kind. Only the actors touched by a query are reset after it
+ */
+class SearchState {
+public:
+    counted_vector<int, MEM_SEARCH_STATE> dist;      // distance from origin, -1 if not reached
+    counted_vector<int, MEM_SEARCH_STATE> prevActor; // actor before this one on its shortest path
+    counted_vector<int, MEM_SEARCH_STATE> prevMovie; // movie connecting prevActor to this actor
+    counted_vector<char, MEM_SEARCH_STATE> done;     // 1 once the actor's distance is final
+    counted_vector<int, MEM_SEARCH_STATE> touched;   // actors reached by the current query
+    FifoFrontier fifo;
+    HeapFrontier heap;
+    BucketFrontier bucket;
+
+    /** make room for numActors actors and forget the previous query */
+    void clear(int numActors)
+    {
+        if(dist.size() != (unsigned int)numActors)
+        {
+            dist.assign(numActors, -1);
+            prevActor.assign(numActors, -1);
+            prevMovie.assign(numActors, -1);
+            done.assign(numActors, 0);
+            touched.clear();
+        }
+
+        for(int id : touched)
+        {
+            dist[id] = -1;
+            done[id] = 0;
+        }
+
+        touched.clear();
+    }
+
+    /** reach actorId at dist through movieId from actor prev */
+    void reach(int actorId, int newDist, int prev, int movieId)
+    {
+        if(dist[actorId] < 0) touched.push_back(actorId);
+
+        dist[actorId] = newDist;
+        prevActor[actorId] = prev;
+        prevMovie[actorId] = movieId;
+    }
+};
+
+inline FifoFrontier& FifoFrontier::in(SearchState& state) {return state.fifo;}
+inline HeapFrontier& HeapFrontier::in(SearchState& state) {return state.heap;}
+inline BucketFrontier& BucketFrontier::in(SearchState& state) {return state.bucket;}
+
+#endif //PA4_SEARCHKERNEL_HPP
@@ -0,0 +1,81 @@
+/**
+ * Filename:     SeparationStats.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Main driver for batch degree of separation analytics. Reads
+ *               actors and movies they starred in from an input file, reads
+ *               a file of source actors, and writes for each source the
+ *               number of actors at every distance (unweighted), its
+ *               eccentricity and closeness. Sources are searched 64 at a
+ *               time with a bit-parallel BFS, spread across threads.
+ *
+ * Arguments: input file, sources file, output file
+ */
+
+#include <iostream>
+#include <fstream>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include "ActorGraph.hpp"
+
+using namespace std;
+
+/** Main driver of SeparationStats implementation. */
+int main(int argc, char* argv[])
+{
+    ActorGraph graph;
+    ifstream sources;    // to read all source actors
+    ofstream statsFile;  // output file to write stats of each source
+    const int NUM_ARGS = 4;  // correct number of args
+    int numThreads = thread::hardware_concurrency(); // threads running BFS
+    int minYear = 0;             // only use movies released from minYear
+    int maxYear = -1;            // to maxYear, if minYear <= maxYear
+
+    // read options following the required args
+    for(int i = NUM_ARGS; i < argc; ++i)
+    {
+        if(!strcmp(argv[i], "--threads") && i + 1 < argc)
+            numThreads = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--years") && i + 2 < argc)
+        {
+            minYear = atoi(argv[++i]);
+            maxYear = atoi(argv[++i]);
+        }
+        else argc = 0; // unknown option, show usage below
+    }
+
+    // check for correct # of args
+    if(argc < NUM_ARGS)
+    {
+        cout << "./separationstats called with incorrect arguments." << endl
+             << "Usage: ./separationstats movie_cast_tsv_file sources_tsv_file "
+                "output_stats_tsv_file [--threads num_threads] "
+                "[--years min_year max_year]" << endl;
+
+        return 0;
+    }
+
+    // populate graph; separation counts movies, so edges are unweighted
+    graph.loadFromFile(argv[1], false, false);
+
+    // restrict searches to movies inside the year window, if one was given
+    if(minYear <= maxYear) graph.setYearWindow(minYear, maxYear);
+
+    sources.open(argv[2]);   // open file of source actors
+    statsFile.open(argv[3]); // open file to write stats to
+
+    // write stats of every source actor
+    graph.writeSeparationStats(sources, statsFile, max(1, numThreads));
+
+    // close all i/o files
+    sources.close();
+    statsFile.close();
+    // done
+
+    return 0;
+}
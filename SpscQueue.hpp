@@ -0,0 +1,62 @@
+/**
+ * Filename:     SpscQueue.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Bounded lock-free queue between exactly one producer thread
+ *               and one consumer thread, used between the stages of the
+ *               ActorGraph load pipeline. A full queue makes the producer
+ *               wait, so fast stages cannot run ahead of slow ones.
+ */
+
+#ifndef PA4_SPSCQUEUE_HPP
+#define PA4_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/** Ring buffer of capacity items. head and tail each have a single writer */
+template <class T>
+class SpscQueue {
+private:
+    vector<T> ring;                 // one slot stays empty to tell full from empty
+    alignas(64) atomic<size_t> head; // next slot to pop; written by consumer
+    alignas(64) atomic<size_t> tail; // next slot to push; written by producer
+
+public:
+    SpscQueue(size_t capacity) : ring(capacity + 1), head(0), tail(0) {}
+
+    /** add item at the back, waiting while the queue is full */
+    void push(const T& item)
+    {
+        size_t curr = tail.load(memory_order_relaxed);
+        size_t next = (curr + 1) % ring.size();
+
+        while(next == head.load(memory_order_acquire))
+            this_thread::yield();
+
+        ring[curr] = item;
+        tail.store(next, memory_order_release);
+    }
+
+    /** remove and return the front item, waiting while the queue is empty */
+    T pop()
+    {
+        size_t curr = head.load(memory_order_relaxed);
+
+        while(curr == tail.load(memory_order_acquire))
+            this_thread::yield();
+
+        T item = ring[curr];
+        head.store((curr + 1) % ring.size(), memory_order_release);
+        return item;
+    }
+};
+
+#endif //PA4_SPSCQUEUE_HPP
@@ -0,0 +1,404 @@
+/**
+ * Filename:     WorkerPool.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com, man7.org (fork, socketpair, poll)
+ *
+ * Description:  Local coordinator that splits a batch of queries into chunks
+ *               and runs them on forked worker processes. Workers are forked
+ *               after the graph is loaded, so they all share its pages
+ *               read-only (copy on write) instead of each loading a copy.
+ *               Each worker talks to the coordinator over a Unix socket pair.
+ *               Chunks are handed out as workers finish, results are written
+ *               in chunk order, and a worker that dies, or takes longer than
+ *               the chunk deadline, is replaced and its chunks are run again.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <poll.h>
+#include <signal.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "WorkerPool.hpp"
+
+/** Results are framed as <chunk, out length, err length>, then out and err */
+struct ResultHeader {
+    int32_t chunk;
+    uint32_t outLen;
+    uint32_t errLen;
+};
+
+/** read exactly len bytes from fd. false on end of file or error */
+static bool readAll(int fd, void* buf, size_t len)
+{
+    char* pos = (char*)buf;
+
+    while(len > 0)
+    {
+        ssize_t got = read(fd, pos, len);
+
+        if(got < 0 && errno == EINTR) continue;
+        if(got <= 0) return false;
+
+        pos += got;
+        len -= got;
+    }
+
+    return true;
+}
+
+/** write exactly len bytes to fd. false if the other end is gone */
+static bool writeAll(int fd, const void* buf, size_t len)
+{
+    const char* pos = (const char*)buf;
+
+    while(len > 0)
+    {
+        // no SIGPIPE if the other end died; the error is handled instead
+        ssize_t put = send(fd, pos, len, MSG_NOSIGNAL);
+
+        if(put < 0 && errno == EINTR) continue;
+        if(put <= 0) return false;
+
+        pos += put;
+        len -= put;
+    }
+
+    return true;
+}
+
+/** run job on items [0, numItems) in chunks spread over the workers.
+ *  Writes each chunk's results to out and errors to err, in item order.
+ *  Returns false if some chunk could not be run
+ */
+bool WorkerPool::run(int numItems, chunk_job job, ostream& out, ostream& err)
+{
+    const int MAX_CHUNK = 64;     // items per chunk, at most
+    const int CHUNKS_PER_WORKER = 8; // smaller chunks balance uneven queries
+    vector<pollfd> polled;        // live worker sockets
+    vector<int> polledWorker;     // worker of each polled socket
+    bool failed = false;
+
+    this->numItems = numItems;
+    this->job = job;
+
+    chunkSize = max(1, min(MAX_CHUNK, numItems / (numWorkers * CHUNKS_PER_WORKER)));
+    numChunks = (numItems + chunkSize - 1) / chunkSize;
+
+    pending.clear();
+    for(int chunk = 0; chunk < numChunks; ++chunk) pending.push_back(chunk);
+
+    tries.assign(numChunks, 0);
+    done.assign(numChunks, 0);
+    outputs.assign(numChunks, string());
+    errors.assign(numChunks, string());
+    nextToWrite = 0;
+
+    // nothing buffered here may be written again by a forked worker
+    out.flush();
+    err.flush();
+    cout.flush();
+
+    workers.assign(numWorkers, WorkerProc());
+    for(WorkerProc& worker : workers) worker.pid = worker.fd = -1;
+
+    while(nextToWrite < numChunks)
+    {
+        polled.clear();
+        polledWorker.clear();
+
+        for(int i = 0; i < numWorkers; ++i)
+        {
+            // start workers, and replace the ones that died
+            if(workers[i].pid < 0 && !pending.empty()) spawn(i);
+            if(workers[i].pid < 0) continue;
+
+            feed(i);
+            polled.push_back(pollfd{workers[i].fd, POLLIN, 0});
+            polledWorker.push_back(i);
+        }
+
+        // no worker could be started; run what is left in this process
+        if(polled.empty())
+        {
+            for(int chunk : pending)
+            {
+                ostringstream chunkOut;
+                ostringstream chunkErr;
+                int begin = chunk * chunkSize;
+
+                job(begin, min(numItems, begin + chunkSize), chunkOut, chunkErr);
+                outputs[chunk] = chunkOut.str();
+                errors[chunk] = chunkErr.str();
+                done[chunk] = 1;
+            }
+
+            pending.clear();
+            flush(out, err);
+            continue;
+        }
+
+        // wake up in time to kill a worker stuck past its deadline
+        if(poll(polled.data(), polled.size(), nextDeadline()) < 0)
+        {
+            if(errno == EINTR) continue;
+
+            err << "Worker pool: poll failed: " << strerror(errno) << endl;
+            failed = true;
+            break;
+        }
+
+        for(unsigned int p = 0; p < polled.size(); ++p)
+            if(polled[p].revents && !collect(polledWorker[p]))
+                lose(polledWorker[p]);
+
+        // a worker that is alive but not answering is as good as dead
+        auto now = chrono::steady_clock::now();
+        for(int i = 0; i < numWorkers; ++i)
+        {
+            WorkerProc& worker = workers[i];
+
+            if(chunkTimeout <= 0 || worker.pid < 0 || worker.sent.empty()
+               || now < worker.deadline)
+                continue;
+
+            int begin = worker.sent.front() * chunkSize;
+            err << "Worker pool: items " << begin << " to "
+                << min(numItems, begin + chunkSize) - 1 << " took over "
+                << chunkTimeout << "s; restarting worker" << endl;
+            lose(i);
+        }
+
+        flush(out, err);
+    }
+
+    // hang up on the workers so they exit, then reap them
+    for(WorkerProc& worker : workers)
+    {
+        if(worker.pid < 0) continue;
+
+        close(worker.fd);
+        waitpid(worker.pid, nullptr, 0);
+        worker.pid = worker.fd = -1;
+    }
+
+    // a chunk given up on has its error written, but no results
+    for(int chunk = 0; chunk < numChunks; ++chunk)
+        if(tries[chunk] >= MAX_TRIES) failed = true;
+
+    return !failed;
+}
+
+/** fork worker i and connect it to this process */
+bool WorkerPool::spawn(int i)
+{
+    int fds[2]; // coordinator end, worker end
+
+    if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) return false;
+
+    pid_t pid = fork();
+
+    if(pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    // worker: drop the coordinator's other sockets, serve, and leave without
+    // running destructors or flushing streams that belong to the coordinator
+    if(pid == 0)
+    {
+        close(fds[0]);
+        for(WorkerProc& worker : workers)
+            if(worker.fd >= 0) close(worker.fd);
+
+        serve(fds[1]);
+        _exit(0);
+    }
+
+    close(fds[1]);
+
+    workers[i].pid = pid;
+    workers[i].fd = fds[0];
+    workers[i].sent.clear();
+    workers[i].received.clear();
+    return true;
+}
+
+/** worker process main loop: answer chunks until the socket closes */
+void WorkerPool::serve(int fd)
+{
+    int32_t chunk;
+
+    while(readAll(fd, &chunk, sizeof(chunk)))
+    {
+        ostringstream chunkOut;
+        ostringstream chunkErr;
+        int begin = chunk * chunkSize;
+
+        job(begin, min(numItems, begin + chunkSize), chunkOut, chunkErr);
+
+        string outText = chunkOut.str();
+        string errText = chunkErr.str();
+        ResultHeader header = {chunk, (uint32_t)outText.size(),
+                               (uint32_t)errText.size()};
+
+        if(!writeAll(fd, &header, sizeof(header))
+           || !writeAll(fd, outText.data(), outText.size())
+           || !writeAll(fd, errText.data(), errText.size()))
+            return;
+    }
+}
+
+/** send chunks to worker i until it has enough in flight */
+void WorkerPool::feed(int i)
+{
+    const unsigned int IN_FLIGHT = 2; // next chunk is queued while one runs
+    WorkerProc& worker = workers[i];
+
+    while(worker.sent.size() < IN_FLIGHT && !pending.empty())
+    {
+        int32_t chunk = pending.front();
+
+        // a dead worker is noticed by poll; keep the chunk pending
+        if(!writeAll(worker.fd, &chunk, sizeof(chunk))) return;
+
+        // an idle worker starts on this chunk right away
+        if(worker.sent.empty())
+            worker.deadline = chrono::steady_clock::now()
+                              + chrono::seconds(chunkTimeout);
+
+        pending.pop_front();
+        worker.sent.push_back(chunk);
+    }
+}
+
+/** read from worker i and store every whole result. Returns false if
+ *  the worker is gone
+ */
+bool WorkerPool::collect(int i)
+{
+    WorkerProc& worker = workers[i];
+    char buf[1 << 16];
+    ssize_t got = read(worker.fd, buf, sizeof(buf));
+
+    if(got < 0 && (errno == EINTR || errno == EAGAIN)) return true;
+    if(got <= 0) return false;
+
+    worker.received.append(buf, got);
+
+    // take every whole result out of the received bytes
+    size_t pos = 0;
+    ResultHeader header;
+
+    while(worker.received.size() - pos >= sizeof(header))
+    {
+        memcpy(&header, worker.received.data() + pos, sizeof(header));
+
+        size_t end = pos + sizeof(header) + header.outLen + header.errLen;
+        if(worker.received.size() < end) break;
+
+        // a worker answers its chunks in the order they were sent
+        if(worker.sent.empty() || worker.sent.front() != header.chunk)
+            return false;
+
+        const char* text = worker.received.data() + pos + sizeof(header);
+        outputs[header.chunk].assign(text, header.outLen);
+        errors[header.chunk].assign(text + header.outLen, header.errLen);
+        done[header.chunk] = 1;
+
+        worker.sent.pop_front();
+        pos = end;
+
+        // the next chunk in flight starts now
+        worker.deadline = chrono::steady_clock::now()
+                          + chrono::seconds(chunkTimeout);
+    }
+
+    worker.received.erase(0, pos);
+    return true;
+}
+
+/** worker i died, hung up or ran past its deadline: reap it and queue
+ *  its chunks again
+ */
+void WorkerPool::lose(int i)
+{
+    WorkerProc& worker = workers[i];
+
+    close(worker.fd);
+    kill(worker.pid, SIGKILL); // may still be alive if it sent garbage
+    waitpid(worker.pid, nullptr, 0);
+    worker.pid = worker.fd = -1;
+
+    // put unanswered chunks back at the front, keeping their order
+    for(auto itr = worker.sent.rbegin(); itr != worker.sent.rend(); ++itr)
+    {
+        int chunk = *itr;
+
+        /** only the first chunk was being run; the others were still
+         *  queued. A chunk that keeps losing workers is given up on
+         */
+        if(chunk == worker.sent.front()) ++tries[chunk];
+
+        if(tries[chunk] >= MAX_TRIES)
+        {
+            int begin = chunk * chunkSize;
+
+            errors[chunk] = "Worker pool: gave up on items " + to_string(begin)
+                            + " to " + to_string(min(numItems, begin + chunkSize) - 1)
+                            + " after " + to_string(MAX_TRIES) + " worker failures\n";
+            done[chunk] = 1;
+        }
+        else pending.push_front(chunk);
+    }
+
+    worker.sent.clear();
+    worker.received.clear();
+}
+
+/** milliseconds until the nearest worker deadline, or -1 if none */
+int WorkerPool::nextDeadline()
+{
+    int wait = -1;
+
+    if(chunkTimeout <= 0) return wait;
+
+    auto now = chrono::steady_clock::now();
+
+    for(WorkerProc& worker : workers)
+    {
+        if(worker.pid < 0 || worker.sent.empty()) continue;
+
+        long long left = chrono::duration_cast<chrono::milliseconds>(
+                                 worker.deadline - now).count();
+        left = max(0LL, left + 1); // round up, so the deadline has passed
+
+        if(wait < 0 || left < wait) wait = (int)left;
+    }
+
+    return wait;
+}
+
+/** write done chunks in order, starting at nextToWrite */
+void WorkerPool::flush(ostream& out, ostream& err)
+{
+    while(nextToWrite < numChunks && done[nextToWrite])
+    {
+        out << outputs[nextToWrite];
+        err << errors[nextToWrite];
+
+        // written results are not needed again
+        outputs[nextToWrite] = string();
+        errors[nextToWrite] = string();
+        ++nextToWrite;
+    }
+}
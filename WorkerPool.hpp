@@ -0,0 +1,103 @@
+/**
+ * Filename:     WorkerPool.hpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com, man7.org (fork, socketpair, poll)
+ *
+ * Description:  Local coordinator that splits a batch of queries into chunks
+ *               and runs them on forked worker processes. Workers are forked
+ *               after the graph is loaded, so they all share its pages
+ *               read-only (copy on write) instead of each loading a copy.
+ *               Each worker talks to the coordinator over a Unix socket pair.
+ *               Chunks are handed out as workers finish, results are written
+ *               in chunk order, and a worker that dies, or takes longer than
+ *               the chunk deadline, is replaced and its chunks are run again.
+ */
+
+#ifndef PA4_WORKERPOOL_HPP
+#define PA4_WORKERPOOL_HPP
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+using namespace std;
+
+/** run items [begin, end) of a batch, writing results to out and errors to err */
+typedef function<void(int begin, int end, ostream& out, ostream& err)> chunk_job;
+
+/** Worker process and the chunks sent to it, oldest first */
+struct WorkerProc {
+    pid_t pid;          // -1 if not running
+    int fd;             // coordinator end of the socket pair
+    deque<int> sent;    // chunks sent and not answered yet
+    string received;    // bytes received that do not form a whole result yet
+    chrono::steady_clock::time_point deadline; // first chunk in sent must be answered by then
+};
+
+/** Runs chunks of a batch on numWorkers processes forked from this one */
+class WorkerPool {
+private:
+    int numWorkers;
+    int chunkTimeout;         // seconds a worker may spend on one chunk (0: no limit)
+    int chunkSize;            // items per chunk
+    int numChunks;
+    int numItems;
+    chunk_job job;
+    vector<WorkerProc> workers;
+    deque<int> pending;       // chunks not sent to any worker, in order
+    vector<int> tries;        // times each chunk was lost with its worker
+    vector<char> done;        // 1 once a chunk's result arrived (or gave up)
+    vector<string> outputs;   // out of each done chunk not written yet
+    vector<string> errors;    // err of each done chunk not written yet
+    int nextToWrite;          // first chunk whose result is not written yet
+
+    /** fork worker i and connect it to this process */
+    bool spawn(int i);
+
+    /** worker process main loop: answer chunks until the socket closes */
+    void serve(int fd);
+
+    /** send chunks to worker i until it has enough in flight */
+    void feed(int i);
+
+    /** read from worker i and store every whole result. Returns false if
+     *  the worker is gone
+     */
+    bool collect(int i);
+
+    /** worker i died, hung up or ran past its deadline: reap it and queue
+     *  its chunks again
+     */
+    void lose(int i);
+
+    /** milliseconds until the nearest worker deadline, or -1 if none */
+    int nextDeadline();
+
+    /** write done chunks in order, starting at nextToWrite */
+    void flush(ostream& out, ostream& err);
+
+public:
+    static const int MAX_TRIES = 3; // chunk is dropped after losing this many workers
+
+    /** pool of numWorkers processes, each given chunkTimeout seconds per
+     *  chunk before it is killed (0: no limit)
+     */
+    WorkerPool(int numWorkers, int chunkTimeout) : numWorkers(numWorkers),
+        chunkTimeout(chunkTimeout), chunkSize(1), numChunks(0), numItems(0),
+        nextToWrite(0) {}
+
+    /** run job on items [0, numItems) in chunks spread over the workers.
+     *  Writes each chunk's results to out and errors to err, in item order.
+     *  Returns false if some chunk could not be run
+     */
+    bool run(int numItems, chunk_job job, ostream& out, ostream& err);
+};
+
+#endif //PA4_WORKERPOOL_HPP
@@ -0,0 +1,127 @@
+/**
+ * Filename:     HopWeightTest.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com
+ *
+ * Description:  Regression test for hop-bounded queries under a selected
+ *               weight policy. With a hop bound no path reaches, the
+ *               hop-bounded search must find paths of the same weight as
+ *               the unbounded kernel, for year weights on an unweighted
+ *               graph and for strength on a weighted one.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <stdio.h>
+#include "../ActorGraph.hpp"
+
+using namespace std;
+
+static const char* CAST_FILE = "hopweight_cast.tsv";
+static const int NUM_ACTORS = 80;
+static const int NUM_MOVIES = 240;
+static const int NUM_PAIRS = 40;
+static const int NO_BOUND_HOPS = 1000; // more movies than any path has
+
+/** Write a cast of small random movies spread over many years, and the
+ *  pairs to query
+ */
+static void writeCast(string& pairs)
+{
+    ofstream cast(CAST_FILE);
+    ostringstream pairLines;
+    unsigned int seed = 12345;
+
+    cast << "Actor/Actress\tMovie\tYear\n";
+    for(int m = 0; m < NUM_MOVIES; ++m)
+    {
+        int year = 1920 + m * 37 % 100;
+
+        for(int j = 0; j < 3; ++j)
+        {
+            seed = seed * 1103515245 + 12345;
+            cast << "Actor " << (seed >> 16) % NUM_ACTORS << "\tMovie " << m
+                 << "\t" << year << "\n";
+        }
+    }
+
+    pairLines << "Actor1/Actress1\tActor2/Actress2\n";
+    for(int p = 0; p < NUM_PAIRS; ++p)
+        pairLines << "Actor " << p % NUM_ACTORS << "\tActor "
+                  << (p * 17 + 5) % NUM_ACTORS << "\n";
+    pairs = pairLines.str();
+}
+
+/** weight of each path written by a query over pairs. Movies weigh their
+ *  year weight, or 1 if unit
+ */
+static vector<int> pathWeights(ActorGraph& graph, const string& pairs,
+                               int maxHops, bool unit)
+{
+    istringstream pairsIn(pairs);
+    ostringstream out;
+    vector<int> weights;
+    string line;
+
+    graph.setSearchBounds(maxHops, -1);
+    graph.writeShortestPaths(pairsIn, out);
+
+    istringstream paths(out.str());
+    while(getline(paths, line))
+    {
+        int weight = 0;
+
+        // every movie of a path is written as [name#@year]
+        for(size_t at = line.find("#@"); at != string::npos;
+            at = line.find("#@", at + 2))
+            weight += unit ? 1 : 1 + (2019 - atoi(line.c_str() + at + 2));
+
+        weights.push_back(weight);
+    }
+
+    return weights;
+}
+
+/** check that a hop bound no path reaches leaves every path weight as is */
+static bool sameWeights(const char* name, bool useWeight, WeightPolicy weights,
+                        bool unit, const string& pairs)
+{
+    ActorGraph graph;
+
+    graph.loadFromFile((char*)CAST_FILE, useWeight, false);
+    graph.selectKernel(weights, HEAP_FRONTIER);
+
+    vector<int> unbounded = pathWeights(graph, pairs, -1, unit);
+    vector<int> bounded = pathWeights(graph, pairs, NO_BOUND_HOPS, unit);
+
+    if(bounded == unbounded) return true;
+
+    cerr << "FAIL: " << name << " paths differ in weight with a hop bound" << endl;
+    return false;
+}
+
+/** see Description */
+int main()
+{
+    string pairs;
+    bool passed = true;
+
+    writeCast(pairs);
+
+    passed = sameWeights("year weights on u graph", false, YEAR_WEIGHT, false, pairs)
+             && passed;
+    passed = sameWeights("strength on w graph", true, CUSTOM_WEIGHT, false, pairs)
+             && passed;
+    passed = sameWeights("unit weights on w graph", true, UNIT_WEIGHT, true, pairs)
+             && passed;
+
+    remove(CAST_FILE);
+
+    cout << (passed ? "PASS" : "FAIL") << ": HopWeightTest" << endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/**
+ * Filename:     LoadRollbackTest.cpp
+ *
+ * Team:         Brandon Olmos (bolmos@ucsd.edu),
+ *               Daryl Nakamoto (dnakamot@ucsd.edu)
+ *
+ * Reference(s): cplusplus.com, zlib.net/manual.html
+ *
+ * Description:  Regression test for ActorGraph::rollbackLoad. Loads a small
+ *               cast file, then a gzip file of new movies cut off in the
+ *               middle, and checks the graph answers exactly as if only the
+ *               first file had been loaded. The cut file holds several
+ *               reader blocks, so records are interned before it fails.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "../ActorGraph.hpp"
+
+using namespace std;
+
+static const char* BASE_FILE = "rollback_base.tsv";
+static const char* CUT_FILE = "rollback_cut.tsv.gz";
+static const char* PAIRS_FILE = "rollback_pairs.tsv";
+static const int BASE_ACTORS = 60;
+static const int BASE_MOVIES = 90;
+static const int CUT_LINES = 400000; // about 12 MB of text, cut in half
+
+/** Write the first file: every movie casts three base actors */
+static void writeBase()
+{
+    ofstream base(BASE_FILE);
+
+    base << "Actor/Actress\tMovie\tYear\n";
+    for(int m = 0; m < BASE_MOVIES; ++m)
+        for(int j = 0; j < 3; ++j)
+            base << "Base Actor " << (m * 7 + j * 13) % BASE_ACTORS << "\tBase Movie "
+                 << m << "\t" << 1950 + m % 60 << "\n";
+
+    ofstream pairs(PAIRS_FILE);
+
+    pairs << "Actor1/Actress1\tActor2/Actress2\n";
+    for(int a = 0; a + 7 < BASE_ACTORS; a += 5)
+        pairs << "Base Actor " << a << "\tBase Actor " << a + 7 << "\n";
+}
+
+/** Write a gzip file of new actors and movies, some sharing base actors,
+ *  and cut it in half so the reader fails past its first blocks
+ */
+static bool writeCut()
+{
+    gzFile out = gzopen(CUT_FILE, "wb");
+    if(!out) return false;
+
+    gzprintf(out, "Actor/Actress\tMovie\tYear\n");
+    for(int i = 0; i < CUT_LINES; ++i)
+    {
+        // new movies link base actors to new ones, and newer years
+        if(i % 3 == 0)
+            gzprintf(out, "Base Actor %d\tNew Movie %d\t%d\n", i % BASE_ACTORS, i / 3,
+                     2000 + i % 19);
+        else
+            gzprintf(out, "New Actor %d\tNew Movie %d\t%d\n", i, i / 3, 2000 + i % 19);
+    }
+    gzclose(out);
+
+    FILE* file = fopen(CUT_FILE, "rb+");
+    if(!file) return false;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+
+    return truncate(CUT_FILE, size / 2) == 0;
+}
+
+/** Everything the graph answers after its loads. MST edges are left out,
+ *  since Kruskal may take either of two movies of the same year; the MST
+ *  totals still have to match
+ */
+static string answers(ActorGraph& graph)
+{
+    ostringstream out;
+    ostringstream mst;
+    ifstream pairs(PAIRS_FILE);
+    string line;
+
+    graph.writeIncidenceStats(out);
+    graph.writeActorsWithPrefix("New", out);
+    graph.writeShortestPaths(pairs, out);
+    graph.buildMST();
+    graph.writeMST(mst);
+
+    istringstream mstLines(mst.str());
+    while(getline(mstLines, line))
+        if(line.find("<--[") == string::npos) out << line << "\n";
+
+    return out.str();
+}
+
+/** see Description */
+int main()
+{
+    ActorGraph expected;
+    ActorGraph rolledBack;
+    bool passed = true;
+
+    writeBase();
+    if(!writeCut())
+    {
+        cerr << "could not write " << CUT_FILE << endl;
+        return 1;
+    }
+
+    expected.loadFromFile((char*)BASE_FILE, true, false);
+    rolledBack.loadFromFile((char*)BASE_FILE, true, false);
+
+    if(rolledBack.loadFromFile((char*)CUT_FILE, true, false))
+    {
+        cerr << "FAIL: cut file loaded without error" << endl;
+        passed = false;
+    }
+
+    if(answers(rolledBack) != answers(expected))
+    {
+        cerr << "FAIL: graph changed by the failed load" << endl;
+        passed = false;
+    }
+
+    remove(BASE_FILE);
+    remove(CUT_FILE);
+    remove(PAIRS_FILE);
+
+    cout << (passed ? "PASS" : "FAIL") << ": LoadRollbackTest" << endl;
+    return passed ? 0 : 1;
+}